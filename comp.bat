@@ -2,6 +2,9 @@
 :: See `license.txt` for more information.
 :: Usage: 'comp <compiler>' where '<compiler>' is one of the following:
 ::   * 68k - Compile for the TI-89/92/Voyage 200 calculators with GCC4TI (TIGCC might also work).
+::   * host - Compile the calculator code for a normal computer with GCC against the tigcclib shim
+::     in `host` and run the frame-time benchmark. See `host/bench.c`. `comp.sh` does the same
+::     thing on Linux.
 ::   * gcc - Compile for a normal computer with GCC using legacy prototype computer code.
 ::   * vs - Compile for Windows with Visual Studio using legacy prototype computer code. Requires
 ::     the usage of the CL command line.
@@ -15,14 +18,22 @@ echo.
 
 :: Program name
 set name=sgl
+if %1==host (
+	set name=bench
+)
 
 :: List of files to compile
 if %1==68k (
 	set files = 		^
 		src/game.c		^
+		src/input.c		^
 		src/map.c		^
 		src/object.c	^
-		src/screen.c
+		src/profile.c	^
+		src/screen.c	^
+		src/sll.c
+) else if %1==host (
+	set files=host/*.c src/*.c
 ) else (
 	set files=comp_src/*.c comp_src/SDL2.lib
 )
@@ -31,6 +42,9 @@ if %1==68k (
 if %1==gcc (
 	gcc -Wall -Wextra -O2 %files% -o %name%
 )
+if %1==host (
+	gcc -Wall -Wextra -Wno-missing-field-initializers -std=gnu99 -O2 -Ihost %files% -o %name%
+)
 if %1==vs (
 	cl /W3 /Fe: %name% %files%
 	del *.obj
@@ -0,0 +1,55 @@
+#!/bin/sh
+# Super Grayland: Copyright 2021 Vincent Robinson under the zlib license.
+# See `license.txt` for more information.
+# Usage: './comp.sh <compiler> [args...]' where '<compiler>' is one of the following:
+#   * 68k - Compile for the TI-89/92/Voyage 200 calculators with GCC4TI (TIGCC might also work).
+#   * host - Compile the calculator code for this computer with GCC against the tigcclib shim in
+#     `host` and run the frame-time benchmark, passing it any extra arguments. See
+#     `host/bench.c`.
+#   * gcc - Compile for this computer with GCC using legacy prototype computer code.
+# This is the Linux counterpart of `comp.bat`; keep the two in sync.
+
+echo "Building Super Grayland..."
+echo
+
+compiler=$1
+shift
+
+# Program name
+name=sgl
+if [ "$compiler" = host ]; then
+	name=bench
+fi
+
+# Compile using the requested compiler
+case "$compiler" in
+68k)
+	# Use -O2 because -O3 triples the executable size with no visible performance increase.
+	tigcc -Wall -Wextra -Wno-missing-field-initializers -std=gnu99 -O2 \
+			src/game.c src/input.c src/map.c src/object.c src/profile.c src/screen.c src/sll.c -o $name
+	;;
+host)
+	gcc -Wall -Wextra -Wno-missing-field-initializers -std=gnu99 -O2 -Ihost \
+			host/*.c src/*.c -o $name
+	;;
+gcc)
+	gcc -Wall -Wextra -O2 comp_src/*.c -lSDL2 -o $name
+	;;
+*)
+	echo "Unknown compiler '$compiler'. Use 68k, host, or gcc."
+	exit 1
+	;;
+esac
+
+# Success!
+status=$?
+echo
+if [ $status -ne 0 ]; then
+	echo "Build failed. Uh, blame Gravil."
+	exit $status
+fi
+echo "Build successful"
+# Run if we've produced an executable file
+if [ "$compiler" != 68k ]; then
+	./$name "$@"
+fi
@@ -32,6 +32,7 @@ const char *ERROR_MESSAGES[ERROR_LEN] = {
 	"An unhandled error occurred; this is probably a bug",
 	"Unable to allocate memory for %s",
 	"Unable to load file \"%s\"",
+	"Unable to save file \"%s\"",
 	"Unable to initialize SDL",
 	"Unable to create window",
 	"Unable to load image \"%s\"",
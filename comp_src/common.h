@@ -23,6 +23,7 @@ typedef  int16_t s16;
 typedef uint16_t u16;
 typedef  int32_t s32;
 typedef uint32_t u32; // WARNING: u32 does not work with some helper or fixed point functions and macros
+typedef uint64_t u64; // Only for timing; never use with helper or fixed point functions and macros
 
 /* Fixed point numbers */
 
@@ -121,6 +122,7 @@ enum error
 	S_ERROR_UNKNOWN,
 	ERROR_ALLOC,
 	ERROR_LOAD_FILE,
+	ERROR_SAVE_FILE,
 	// SDL-specific errors
 	S_ERROR_SDL_INIT,
 	S_ERROR_SDL_CREATE_WINDOW,
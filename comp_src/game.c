@@ -1,6 +1,7 @@
 // Super Grayland, Copyright 2020 Vincent Robinson under the zlib license. See 'LICENSE.txt' for more information.
 
 #include "game.h"
+#include "input.h"
 #include "map.h"
 #include "player.h"
 #include "screen.h"
@@ -40,8 +41,9 @@ void deinit_game(void)
 
 bool mainloop(void)
 {
-	// Frame start time for frame rate capping
+	// Frame start time for frame rate capping and timing headless frames
 	u32 frame_start = SDL_GetTicks();
+	u64 frame_counter = SDL_GetPerformanceCounter();
 
 	// Handle Alt-F4 or the close button
 	SDL_Event event;
@@ -53,7 +55,15 @@ bool mainloop(void)
 	}
 
 	// Get keys for passing to helper functions
-	const u8 *keys = SDL_GetKeyboardState(NULL);
+	keys_t keys;
+	if (update_input(&keys))
+		return FAILURE;
+
+	// A headless game only exists to play the replay
+	if (g_game.headless && g_input.done) {
+		g_game.state = STATE_QUIT;
+		return SUCCESS;
+	}
 
 	// Depending on the current state, do different things
 	switch (g_game.state) {
@@ -68,10 +78,26 @@ bool mainloop(void)
 
 	case STATE_LEVEL:
 		update_player(keys);
-		draw_screen();
+		update_objects();
+		if (!g_game.headless)
+			draw_screen();
 		break;
 	}
 
+	if (g_game.headless) {
+		u64 time = (SDL_GetPerformanceCounter() - frame_counter) * 1000000000 / SDL_GetPerformanceFrequency();
+
+		u8 bucket = 0;
+		while (bucket < FRAME_HISTOGRAM_LEN - 1 && time >> (bucket + 1))
+			bucket++;
+
+		g_game.frame_histogram[bucket]++;
+		g_game.total_time += time;
+		g_game.num_frames++;
+
+		return SUCCESS;
+	}
+
 	// Cap the frame rate
 	u32 diff = SDL_GetTicks() - frame_start;
 	if (diff < TIME_PER_FRAME)
@@ -79,3 +105,14 @@ bool mainloop(void)
 
 	return SUCCESS;
 }
+
+void print_frame_times(void)
+{
+	printf("Played %u frames in %llu ns, %llu ns per frame\n", g_game.num_frames, (unsigned long long)g_game.total_time,
+			(unsigned long long)(g_game.num_frames ? g_game.total_time / g_game.num_frames : 0));
+
+	for (u8 i = 0; i < FRAME_HISTOGRAM_LEN; i++) {
+		if (g_game.frame_histogram[i])
+			printf("%10llu - %10llu ns: %u\n", 1ULL << i, (2ULL << i) - 1, g_game.frame_histogram[i]);
+	}
+}
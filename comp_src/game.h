@@ -12,11 +12,22 @@ enum state
 	STATE_LEVEL
 };
 
+// Number of powers of two of nanoseconds in the frame time histogram
+#define FRAME_HISTOGRAM_LEN 32
+
 // The game and all data common to it that is not tied to any other specific thing
 struct game
 {
 	// Current game state
 	enum state state;
+
+	// Headless games don't draw anything or cap the frame rate, and time every frame instead. They quit once a replay is
+	// done, so they're only useful when replaying.
+	bool headless;
+	u32 num_frames;
+	u64 total_time;
+	// Number of frames that took at least 2^i and under 2^(i + 1) nanoseconds for each i
+	u32 frame_histogram[FRAME_HISTOGRAM_LEN];
 };
 
 // Global game variable
@@ -28,3 +39,6 @@ void deinit_game(void);
 
 // Game main loop, runs everything for a single frame
 bool mainloop(void);
+
+// Print the total time, average time, and histogram of frame times of a headless game
+void print_frame_times(void);
@@ -0,0 +1,206 @@
+// Super Grayland, Copyright 2020 Vincent Robinson under the zlib license. See 'LICENSE.txt' for more information.
+
+#include "input.h"
+
+struct input g_input;
+
+// Number of runs reserved when recording starts; this is doubled every time it runs out
+#define INPUT_RUN_SPACE 256
+
+// Read a big endian u16 from a file
+static bool read_u16(FILE *file, u16 *num)
+{
+	if (fread(num, sizeof(u16), 1, file) != 1)
+		return FAILURE;
+
+	endian_swap(num);
+	return SUCCESS;
+}
+
+// Write a u16 to a file as big endian
+static bool write_u16(FILE *file, u16 num)
+{
+	endian_swap(&num);
+	return fwrite(&num, sizeof(u16), 1, file) != 1;
+}
+
+// Load all the runs in the file being replayed
+static bool load_runs(void)
+{
+	FILE *file = fopen(g_input.path, "rb");
+	if (file == NULL) {
+		ERROR(LOAD_FILE, g_input.path);
+		return FAILURE;
+	}
+
+	char magic[4];
+	u16 version;
+	if (fread(magic, 1, 4, file) != 4 || memcmp(magic, "SGLI", 4) || read_u16(file, &version) ||
+			version != INPUT_FILE_VERSION || read_u16(file, &g_input.num_runs)) {
+		ERROR(LOAD_FILE, g_input.path);
+		goto close_file;
+	}
+
+	g_input.runs = malloc(sizeof(struct input_run) * g_input.num_runs);
+	if (g_input.runs == NULL && g_input.num_runs != 0) {
+		ERROR(ALLOC, "input runs");
+		goto close_file;
+	}
+
+	for (u16 i = 0; i < g_input.num_runs; i++) {
+		if (read_u16(file, &g_input.runs[i].keys) || read_u16(file, &g_input.runs[i].frames)) {
+			ERROR(LOAD_FILE, g_input.path);
+			goto close_file;
+		}
+	}
+
+	fclose(file);
+	return SUCCESS;
+
+close_file:
+	fclose(file);
+	return FAILURE;
+}
+
+// Save all the recorded runs to the file being recorded
+static bool save_runs(void)
+{
+	FILE *file = fopen(g_input.path, "wb");
+	if (file == NULL) {
+		ERROR(SAVE_FILE, g_input.path);
+		return FAILURE;
+	}
+
+	bool failed = fwrite("SGLI", 1, 4, file) != 4 || write_u16(file, INPUT_FILE_VERSION) ||
+			write_u16(file, g_input.num_runs);
+	for (u16 i = 0; i < g_input.num_runs && !failed; i++)
+		failed = write_u16(file, g_input.runs[i].keys) || write_u16(file, g_input.runs[i].frames);
+
+	if (fclose(file))
+		failed = true;
+
+	if (failed) {
+		ERROR(SAVE_FILE, g_input.path);
+		return FAILURE;
+	}
+	return SUCCESS;
+}
+
+bool init_input(enum input_mode mode, const char path[])
+{
+	g_input = (struct input) {
+		.mode = mode,
+		.path = path
+	};
+
+	if (mode == INPUT_REPLAY) {
+		if (load_runs())
+			return FAILURE;
+		g_input.done = g_input.num_runs == 0;
+	} else if (mode == INPUT_RECORD) {
+		g_input.runs = malloc(sizeof(struct input_run) * INPUT_RUN_SPACE);
+		if (g_input.runs == NULL) {
+			ERROR(ALLOC, "input runs");
+			return FAILURE;
+		}
+		g_input.reserved_runs = INPUT_RUN_SPACE;
+	}
+
+	return SUCCESS;
+}
+
+bool deinit_input(void)
+{
+	bool failed = g_input.mode == INPUT_RECORD && g_input.runs != NULL && save_runs();
+
+	free(g_input.runs);
+	g_input = (struct input) {0};
+
+	return failed;
+}
+
+// Read every key the game uses from the keyboard
+static keys_t read_keys(void)
+{
+	const u8 *state = SDL_GetKeyboardState(NULL);
+	keys_t keys = 0;
+
+	if (state[SDL_SCANCODE_UP])
+		keys |= 1 << KEY_UP;
+	if (state[SDL_SCANCODE_DOWN])
+		keys |= 1 << KEY_DOWN;
+	if (state[SDL_SCANCODE_LEFT])
+		keys |= 1 << KEY_LEFT;
+	if (state[SDL_SCANCODE_RIGHT])
+		keys |= 1 << KEY_RIGHT;
+	if (state[SDL_SCANCODE_A])
+		keys |= 1 << KEY_RUN;
+	if (state[SDL_SCANCODE_ESCAPE])
+		keys |= 1 << KEY_ESCAPE;
+	if (state[SDL_SCANCODE_S])
+		keys |= 1 << KEY_JUMP;
+
+	return keys;
+}
+
+// Add the keys of this frame to the last run if they're the same, or start a new run if not
+static bool record_keys(keys_t keys)
+{
+	if (g_input.num_runs != 0) {
+		struct input_run *last = &g_input.runs[g_input.num_runs - 1];
+		if (last->keys == keys && last->frames != 0xFFFF) {
+			last->frames++;
+			return SUCCESS;
+		}
+	}
+
+	// Double the reserved space if it runs out
+	if (g_input.num_runs == g_input.reserved_runs) {
+		if (g_input.reserved_runs == 0xFFFF) {
+			ERROR(ALLOC, "input runs");
+			return FAILURE;
+		}
+
+		u16 reserved = g_input.reserved_runs > 0x7FFF ? 0xFFFF : g_input.reserved_runs * 2;
+		struct input_run *runs = realloc(g_input.runs, sizeof(struct input_run) * reserved);
+		if (runs == NULL) {
+			ERROR(ALLOC, "input runs");
+			return FAILURE;
+		}
+
+		g_input.runs = runs;
+		g_input.reserved_runs = reserved;
+	}
+
+	g_input.runs[g_input.num_runs++] = (struct input_run) {keys, 1};
+	return SUCCESS;
+}
+
+// Take the keys of this frame from the replay, moving on to the next run once all its frames have been played
+static keys_t replay_keys(void)
+{
+	// Runs of zero frames are skipped
+	while (!g_input.done && g_input.frame >= g_input.runs[g_input.run].frames) {
+		g_input.frame = 0;
+		g_input.done = ++g_input.run == g_input.num_runs;
+	}
+	if (g_input.done)
+		return 0;
+
+	g_input.frame++;
+	return g_input.runs[g_input.run].keys;
+}
+
+bool update_input(keys_t *keys)
+{
+	if (g_input.mode == INPUT_REPLAY) {
+		*keys = replay_keys();
+		return SUCCESS;
+	}
+
+	*keys = read_keys();
+	if (g_input.mode == INPUT_RECORD)
+		return record_keys(*keys);
+
+	return SUCCESS;
+}
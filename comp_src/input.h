@@ -0,0 +1,77 @@
+// Super Grayland, Copyright 2020 Vincent Robinson under the zlib license. See 'LICENSE.txt' for more information.
+
+#pragma once
+
+#include "common.h"
+
+/* Input:
+	* The game never reads the keyboard itself. Instead, 'update_input' reads every key the game uses once per frame into a
+	  key mask, which is passed around and checked with KEY_PRESSED.
+	* The key mask can also be recorded to a file and replayed from it, so exactly the same game can be played again, such
+	  as to time two builds against each other with '--replay <file> --headless'.
+	* Keys usually stay the same for many frames at a time, so they are stored as runs of frames with the same keys. Files
+	  have the same layout as the calculator version's 'sgli' files, all big endian: the characters "SGLI", the version,
+	  the number of runs, and then the keys and number of frames of each run.
+*/
+
+// Bits of the key mask for each key the game uses. The ones the calculator version also has use the same bits.
+enum key
+{
+	KEY_UP,
+	KEY_DOWN,
+	KEY_LEFT,
+	KEY_RIGHT,
+	KEY_RUN,
+	KEY_ESCAPE,
+	KEY_JUMP = 7
+};
+
+typedef u16 keys_t;
+
+// Check if a key is pressed in a key mask
+#define KEY_PRESSED(keys, key) (((keys) & (1 << (key))) != 0)
+
+#define INPUT_FILE_VERSION 1
+
+// Where the keys come from
+enum input_mode
+{
+	INPUT_LIVE,   // Only from the keyboard
+	INPUT_RECORD, // From the keyboard, saving them to a file when deinitializing
+	INPUT_REPLAY  // From a file, ignoring the keyboard
+};
+
+// A number of frames in a row with the same keys pressed
+struct input_run
+{
+	keys_t keys;
+	u16 frames;
+};
+
+struct input
+{
+	enum input_mode mode;
+	// File to record to or replay from
+	const char *path;
+
+	// Recorded runs or runs being replayed
+	struct input_run *runs;
+	u16 num_runs;
+	u16 reserved_runs;
+
+	// The run being replayed and how many of its frames have been played
+	u16 run;
+	u16 frame;
+	// Set when every run has been replayed
+	bool done;
+};
+
+// Global input variable
+extern struct input g_input;
+
+// Initialize/deinitialize input. Replaying loads the whole file at once, and recording saves it when deinitializing.
+bool init_input(enum input_mode mode, const char path[]);
+bool deinit_input(void);
+
+// Get the keys for the next frame. When a replay is done, no keys are pressed.
+bool update_input(keys_t *keys);
@@ -5,11 +5,36 @@
 
 #include "common.h"
 #include "game.h"
+#include "input.h"
 #include "map.h"
 #include "screen.h"
 
-int main(void)
+int main(int argc, char *argv[])
 {
+	// Parse the arguments: '--record <file>' or '--replay <file>', and '--headless' to replay as fast as possible
+	enum input_mode input_mode = INPUT_LIVE;
+	const char *input_path = NULL;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--record") && i + 1 < argc) {
+			input_mode = INPUT_RECORD;
+			input_path = argv[++i];
+		} else if (!strcmp(argv[i], "--replay") && i + 1 < argc) {
+			input_mode = INPUT_REPLAY;
+			input_path = argv[++i];
+		} else if (!strcmp(argv[i], "--headless")) {
+			g_game.headless = true;
+		} else {
+			fprintf(stderr, "Usage: %s [--record <file> | --replay <file> [--headless]]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (g_game.headless && input_mode != INPUT_REPLAY) {
+		fprintf(stderr, "--headless needs --replay\n");
+		return 1;
+	}
+
 	printf("--------------------------------------------------\n" // TODO: Careful with s32 and %d; they might not be the same
 			"Super Grayland v1.0\n"
 			"--------------------------------------------------\n"
@@ -34,6 +59,9 @@ int main(void)
 	if (init_map())
 		goto deinit_game;
 
+	if (init_input(input_mode, input_path))
+		goto deinit_input;
+
 	// Run main loop
 	while (g_game.state != STATE_QUIT) {
 		if (mainloop()) {
@@ -42,7 +70,12 @@ int main(void)
 		}
 	}
 
+	if (g_game.headless)
+		print_frame_times();
+
 	// Deinitialize
+deinit_input:
+	deinit_input();
 deinit_game:
 	deinit_game();
 deinit_display: // TODO: Correct cleanup
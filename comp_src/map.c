@@ -69,7 +69,11 @@ bool init_map(void)
 		.pos = {Frac_NEW(pos_t, 8), Frac_NEW(pos_t, 8)},
 	};
 
-	g_map.objects = malloc(sizeof(struct obj) * 2);
+	// Reserve room for spawned objects up front so that adding them doesn't have to allocate
+	g_map.num_objects = 2;
+	g_map.reserved_obj_space = g_map.num_objects + OBJ_SPAWN_SPACE;
+
+	g_map.objects = malloc(sizeof(struct obj) * g_map.reserved_obj_space);
 	if (g_map.objects == NULL) {
 		ERROR(ALLOC, "objects");
 		return FAILURE;
@@ -77,9 +81,6 @@ bool init_map(void)
 	g_map.objects[0] = player;
 	g_map.objects[1] = bob_ross;
 
-	g_map.num_objects = 2;
-	g_map.reserved_obj_space = 2;
-
 	g_map.player_index = 0;
 	g_map.left_index = 0;
 	g_map.right_index = 1;
@@ -196,17 +197,22 @@ struct obj *add_obj(pos_t pos_x)
 		ERROR(ALLOC, "objects");
 		return NULL;
 	}
-	g_map.num_objects++;
 
-	// Increase the size to accommodate the extra object if necessary
-	if (g_map.num_objects > g_map.reserved_obj_space) {
-		g_map.reserved_obj_space++;
-		g_map.objects = realloc(g_map.objects, sizeof(struct obj) * g_map.num_objects);
-		if (g_map.objects == NULL) {
+	// Double the space if it is full, so that spawning lots of objects only reallocates a few times. The free space
+	// is always at the end of the list, so no other bookkeeping is needed to reuse the space of removed objects.
+	if (g_map.num_objects == g_map.reserved_obj_space) {
+		u16 new_space = g_map.reserved_obj_space > 65535 / 2 ? 65535 : g_map.reserved_obj_space * 2;
+
+		struct obj *new_objects = realloc(g_map.objects, sizeof(struct obj) * new_space);
+		if (new_objects == NULL) {
 			ERROR(ALLOC, "objects");
 			return NULL;
 		}
+
+		g_map.objects = new_objects;
+		g_map.reserved_obj_space = new_space;
 	}
+	g_map.num_objects++;
 
 	// Create the object in the empty position after the end of the list
 	u16 new_obj_index = g_map.num_objects - 1;
@@ -221,36 +227,29 @@ struct obj *add_obj(pos_t pos_x)
 
 	// Using the provided X position, find the correct sorted place for the object.
 	// Start searching from the player position as the newly created object is likely to be near the player.
-	struct obj *it = get_obj(g_map.player_index);
-	if (pos_x >= it->pos.x) {
-		// Advance iterator immediately as the player object doesn't need to be checked twice
-		u16 it_index = it->right;
-		it = get_right_obj(it, NULL_INDEX);
-
-		for (; it != NULL; it_index = it->right, it = get_right_obj(it, NULL_INDEX)) {
-			// If the iterator has passed the right of the object, insert the new object to the left of it
-			if (it->pos.x > pos_x) {
-				move_obj_left_of(new_obj_index, it_index);
-				goto search_end;
-			}
-		}
+	// The search stops at the last object passed rather than running off the end of the list, which has no object to
+	// insert next to.
+	u16 it_index = g_map.player_index;
+	if (pos_x >= get_obj(it_index)->pos.x) {
+		// Pass every object that isn't to the right of the new object, then insert the new object to the right of it
+		u16 right;
+		while ((right = get_obj(it_index)->right) != NULL_INDEX && get_obj(right)->pos.x <= pos_x)
+			it_index = right;
 
-		// No suitable position was found to the left of any objects, so insert the object at the very right
 		move_obj_right_of(new_obj_index, it_index);
 	} else {
-		u16 it_index = it->left;
-		it = get_left_obj(it, NULL_INDEX);
-
-		for (; it != NULL; it_index = it->left, it = get_left_obj(it, NULL_INDEX)) {
-			if (it->pos.x < pos_x) {
-				move_obj_right_of(new_obj_index, it_index);
-				goto search_end;
-			}
-		}
+		u16 left;
+		while ((left = get_obj(it_index)->left) != NULL_INDEX && get_obj(left)->pos.x >= pos_x)
+			it_index = left;
 
 		move_obj_left_of(new_obj_index, it_index);
 	}
-search_end:
+
+	// The object may have become the leftmost or rightmost object
+	if (new_obj->left == NULL_INDEX)
+		g_map.left_index = new_obj_index;
+	if (new_obj->right == NULL_INDEX)
+		g_map.right_index = new_obj_index;
 
 	return new_obj;
 }
@@ -259,10 +258,49 @@ void remove_obj(u16 index)
 {
 	// Note that there will always be at least one object in the list, the player, so no checks need to be
 	// made to see if the list is empty.
-
-	// We don't realloc the object list space smaller because that might take extra time. We don't need to
-	// conserve memory anyway as the object list is the only thing that will ever be realloced
-	g_map.num_objects--;
-
-	// TODO
+	struct obj *obj = get_obj(index);
+
+	// The active slice always contains the player, which is never removed, so there is always another object to move
+	// the edge of the slice to.
+	if (g_map.left_active_index == index)
+		g_map.left_active_index = obj->right;
+	if (g_map.right_active_index == index)
+		g_map.right_active_index = obj->left;
+
+	// Unlink the object
+	if (obj->left != NULL_INDEX)
+		get_obj(obj->left)->right = obj->right;
+	else
+		g_map.left_index = obj->right;
+
+	if (obj->right != NULL_INDEX)
+		get_obj(obj->right)->left = obj->left;
+	else
+		g_map.right_index = obj->left;
+
+	// We don't realloc the object list space smaller because that might take extra time, and the space will most
+	// likely be filled again by the next objects that are spawned.
+	u16 last_index = --g_map.num_objects;
+	if (index == last_index)
+		return;
+
+	// Move the top object into the vacated place and point everything that referenced it to the new place
+	*obj = *get_obj(last_index);
+
+	if (obj->left != NULL_INDEX)
+		get_obj(obj->left)->right = index;
+	else
+		g_map.left_index = index;
+
+	if (obj->right != NULL_INDEX)
+		get_obj(obj->right)->left = index;
+	else
+		g_map.right_index = index;
+
+	if (g_map.player_index == last_index)
+		g_map.player_index = index;
+	if (g_map.left_active_index == last_index)
+		g_map.left_active_index = index;
+	if (g_map.right_active_index == last_index)
+		g_map.right_active_index = index;
 }
@@ -250,7 +250,7 @@ struct map
 	struct obj *objects;
 	// Full number of objects in the level
 	u16 num_objects;
-	// How much space is reserved for the objects
+	// How much space is reserved for the objects. It doubles whenever it runs out.
 	u16 reserved_obj_space;
 	// Index of the player object
 	u16 player_index;
@@ -281,6 +281,10 @@ struct map
 // The map version for compatibility with older maps
 #define MAP_VERSION 0
 
+// Extra object space reserved when a level is loaded so that spawned objects don't need any allocations until there are
+// more of them at once than this.
+#define OBJ_SPAWN_SPACE 64
+
 // Radius in tiles from the player's position to update objects. In total, the active object range is two whole screens wide.
 #define ACTIVE_OBJ_RADIUS SCREEN_TILES_X
 
@@ -316,7 +320,7 @@ void move_obj_left_of (u16 obj, u16 other);
 // else is zeroed. Returns NULL if it could not be created.
 struct obj *add_obj(pos_t pos_x);
 
-// Removes an object from the object list and moves the top object into the vacated place.
+// Removes an object from the object list and moves the top object into the vacated place. The player must not be removed.
 void remove_obj(u16 index);
 
 /*
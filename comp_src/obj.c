@@ -52,9 +52,75 @@ v2_pixel_t get_rect_center(const struct obj_def *def)
 	};
 }
 
-void update_objects(void)
+// Returns true if an object at the X position 'pos_x' is close enough to the player to be active
+static bool is_active_pos(pos_t pos_x)
 {
-	// TODO: Updating objects
+	pos_t center = get_obj(g_map.player_index)->pos.x;
+	pos_t radius = Frac_CONVERT(tile_t, pos_t, ACTIVE_OBJ_RADIUS);
+
+	return pos_x >= center - radius && pos_x <= center + radius;
+}
+
+// Moves the edges of the active object slice to the objects that are now in or out of range. Since the list is sorted, only
+// the objects at the edges need to be checked, so this only takes as long as the number of objects that entered or left.
+static void update_active_slice(void)
+{
+	// Extend the slice first so that edges which have been passed by other objects get back to the outside of the slice.
+	u16 left;
+	while ((left = get_obj(g_map.left_active_index)->left) != NULL_INDEX && is_active_pos(get_obj(left)->pos.x))
+		g_map.left_active_index = left;
+	u16 right;
+	while ((right = get_obj(g_map.right_active_index)->right) != NULL_INDEX && is_active_pos(get_obj(right)->pos.x))
+		g_map.right_active_index = right;
+
+	// The player is always active, so shrinking never goes past it.
+	while (g_map.left_active_index != g_map.player_index && !is_active_pos(get_obj(g_map.left_active_index)->pos.x))
+		g_map.left_active_index = get_obj(g_map.left_active_index)->right;
+	while (g_map.right_active_index != g_map.player_index && !is_active_pos(get_obj(g_map.right_active_index)->pos.x))
+		g_map.right_active_index = get_obj(g_map.right_active_index)->left;
+}
+
+// Puts the objects in the active slice back in order after they moved. This is an insertion sort, which is fast since
+// objects only move a few pixels per frame and so only swap with their closest neighbours, if anything.
+static void sort_active_objects(void)
+{
+	// Inactive objects don't move, so the list is sorted once the sort has passed the slice and reaches an object that is
+	// in order. Objects that moved right past the end of the slice are caught by continuing until then.
+	bool past_slice = false;
+
+	for (u16 index = g_map.left_active_index; index != NULL_INDEX;) {
+		struct obj *obj = get_obj(index);
+		u16 next = obj->right;
+
+		if (index == g_map.right_active_index)
+			past_slice = true;
+
+		if (obj->left != NULL_INDEX && get_obj(obj->left)->pos.x > obj->pos.x) {
+			// Find the leftmost object that is still to the right of this one
+			u16 other = obj->left;
+			bool passed_left_edge = other == g_map.left_active_index;
+			while (get_obj(other)->left != NULL_INDEX && get_obj(get_obj(other)->left)->pos.x > obj->pos.x) {
+				other = get_obj(other)->left;
+				passed_left_edge |= other == g_map.left_active_index;
+			}
+
+			// Keep the objects that were in the slice inside it. The final positions decide what stays active afterwards.
+			if (passed_left_edge)
+				g_map.left_active_index = index;
+			if (g_map.right_active_index == index)
+				g_map.right_active_index = obj->left;
+
+			if (g_map.right_index == index)
+				g_map.right_index = obj->left;
+			move_obj_left_of(index, other);
+			if (obj->left == NULL_INDEX)
+				g_map.left_index = index;
+		} else if (past_slice && index != g_map.right_active_index) {
+			break;
+		}
+
+		index = next;
+	}
 }
 
 enum hit tile_collision(struct obj *obj)
@@ -208,6 +274,28 @@ enum hit tile_collision(struct obj *obj)
 	return dir;
 }
 
+// Get the upper left and lower right corners of an object's rect
+static void get_obj_rect(const struct obj *obj, v2_pos_t *ul, v2_pos_t *lr)
+{
+	const struct obj_def *def = get_obj_def(obj->type);
+
+	ul->x = Frac_CONVERT(pixel_t, pos_t, def->rect_offset.x) + obj->pos.x;
+	ul->y = Frac_CONVERT(pixel_t, pos_t, def->rect_offset.y) + obj->pos.y;
+	lr->x = Frac_CONVERT(pixel_t, pos_t, def->rect_size.x) + ul->x;
+	lr->y = Frac_CONVERT(pixel_t, pos_t, def->rect_size.y) + ul->y;
+}
+
+// Check whether the rects of two objects overlap with AABB collision detection
+static bool objs_overlap(const struct obj *first, const struct obj *second)
+{
+	v2_pos_t first_ul, first_lr, second_ul, second_lr;
+	get_obj_rect(first, &first_ul, &first_lr);
+	get_obj_rect(second, &second_ul, &second_lr);
+
+	return first_ul.x < second_lr.x && first_lr.x > second_ul.x &&
+		first_ul.y < second_lr.y && first_lr.y > second_ul.y;
+}
+
 // Get the hit direction the object-object collision was in
 static enum hit get_hit_dir(vel_t first, vel_t second, enum hit top_left, enum hit bottom_right)
 {
@@ -256,35 +344,9 @@ enum hit obj_collision(struct obj *first, struct obj *second)
 	// Object collision detection is simple AABB collision with velocity checks to determine collision direction
 	// TODO: Pushout for solid objects
 
-	const struct obj_def *first_def  = get_obj_def(first->type);
-	const struct obj_def *second_def = get_obj_def(second->type);
-
-	// Upper left corners
-	v2_pos_t first_ul = {
-		Frac_CONVERT(pixel_t, pos_t, first_def->rect_offset.x) + first->pos.x,
-		Frac_CONVERT(pixel_t, pos_t, first_def->rect_offset.y) + first->pos.y
-	};
-	v2_pos_t second_ul = {
-		Frac_CONVERT(pixel_t, pos_t, second_def->rect_offset.x) + second->pos.x,
-		Frac_CONVERT(pixel_t, pos_t, second_def->rect_offset.y) + second->pos.y
-	};
-
-	// Lower right corners
-	v2_pos_t first_lr = {
-		Frac_CONVERT(pixel_t, pos_t, first_def->rect_size.x) + first_ul.x,
-		Frac_CONVERT(pixel_t, pos_t, first_def->rect_size.y) + first_ul.y
-	};
-	v2_pos_t second_lr = {
-		Frac_CONVERT(pixel_t, pos_t, second_def->rect_size.x) + second_ul.x,
-		Frac_CONVERT(pixel_t, pos_t, second_def->rect_size.y) + second_ul.y
-	};
-
 	enum hit dir = HIT_NONE;
 
-	// Check for collision with AABB collision detection
-	if (first_ul.x < second_lr.x && first_lr.x > second_ul.x &&
-		first_ul.y < second_lr.y && first_lr.y > second_ul.y)
-	{
+	if (objs_overlap(first, second)) {
 		// Find the direction the collision was in ('HIT_*' values)
 		enum hit vert  = get_hit_dir(first->vel.y, second->vel.y, HIT_TOP, HIT_BOTTOM);
 		enum hit horiz = get_hit_dir(first->vel.x, second->vel.x, HIT_LEFT, HIT_RIGHT);
@@ -327,3 +389,87 @@ enum hit obj_collision(struct obj *first, struct obj *second)
 
 	return dir;
 }
+
+// Swap each 'HIT_*' value with the opposite side, turning the hit of one object on another into the hit of the other
+// object on the first. The values of opposite sides are always next to each other.
+static enum hit mirror_hit(enum hit hit)
+{
+	return ((hit & 0x55) << 1) | ((hit & 0xAA) >> 1);
+}
+
+// Gets the object that collides for an index in the list. The player's place in the list only follows the real player.
+static struct obj *get_colliding_obj(u16 index)
+{
+	if (index == g_map.player_index)
+		return &g_map.player->obj;
+	return get_obj(index);
+}
+
+// Runs the collision callbacks of every pair of active objects that are touching. This is a sweep and prune: since the
+// list is sorted and rects are never to the left of their object's position, only the objects to the right of an object
+// up to the right side of its rect need to be checked, which is usually none or just a couple.
+static void collide_active_objects(void)
+{
+	u16 end = get_obj(g_map.right_active_index)->right;
+	for (u16 index = g_map.left_active_index; index != end; index = get_obj(index)->right) {
+		struct obj *first = get_colliding_obj(index);
+		const struct obj_def *first_def = get_obj_def(first->type);
+		if (first_def->no_obj_collision)
+			continue;
+
+		pos_t first_right = first->pos.x + Frac_CONVERT(pixel_t, pos_t, first_def->rect_offset.x + first_def->rect_size.x);
+
+		for (u16 other = get_obj(index)->right; other != end; other = get_obj(other)->right) {
+			struct obj *second = get_colliding_obj(other);
+			if (second->pos.x >= first_right)
+				break;
+
+			const struct obj_def *second_def = get_obj_def(second->type);
+			if (second_def->no_obj_collision || !objs_overlap(first, second))
+				continue;
+
+			// Each pair is only found once, so both objects are told about it here.
+			enum hit hit = obj_collision(first, second);
+			if (first_def->collide != NULL)
+				first_def->collide(first, hit, second);
+			if (second_def->collide != NULL)
+				second_def->collide(second, mirror_hit(hit), first);
+		}
+	}
+}
+
+// The player is updated by itself in 'update_player', so its place in the list just follows it. This copies the real
+// player into its place whenever the player may have moved.
+static void sync_player_entry(void)
+{
+	get_obj(g_map.player_index)->pos = g_map.player->obj.pos;
+	get_obj(g_map.player_index)->vel = g_map.player->obj.vel;
+}
+
+void update_objects(void)
+{
+	sync_player_entry();
+	update_active_slice();
+
+	// Objects are visited in order through the links, which don't change until every object has moved.
+	u16 end = get_obj(g_map.right_active_index)->right;
+	for (u16 index = g_map.left_active_index; index != end; index = get_obj(index)->right) {
+		if (index == g_map.player_index)
+			continue;
+
+		struct obj *obj = get_obj(index);
+		const struct obj_def *def = get_obj_def(obj->type);
+		if (def->update != NULL)
+			def->update(obj);
+	}
+
+	sort_active_objects();
+
+	// Collision callbacks may push objects apart, including the real player, so sort them again afterwards. It's cheap
+	// when nothing moved.
+	collide_active_objects();
+	sync_player_entry();
+	sort_active_objects();
+
+	update_active_slice();
+}
@@ -97,7 +97,8 @@ struct obj_def
 	void (*update)(struct obj *obj);
 
 	// Called when this object collides with another. Note that this callback will also be called for the other object
-	// as well. NULL if nothing happens on collision.
+	// as well. 'hit' is the side(s) of the other object that this one hit, as from 'obj_collision', so the other object
+	// gets the opposite sides. NULL if nothing happens on collision.
 	void (*collide)(struct obj *obj, enum hit hit, struct obj *other);
 
 	// Size (width and height) and offset from the top-left of the object's internal position for the collision box
@@ -137,6 +138,8 @@ v2_pixel_t get_rect_center(const struct obj_def *def);
 void step_animation(struct obj *obj, u8 extra_delay, u8 highest_frame_offset);
 
 // Update all objects: Modifying active object range, updating objects, moving them, collision detection, etc.
+// Objects' update and collide callbacks may move them freely; the object list is sorted again afterwards. They must not
+// add or remove objects, since that would change the list while it is being walked.
 void update_objects(void);
 
 // Check for object-tile collision and move the object out of collision.
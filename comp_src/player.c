@@ -3,7 +3,7 @@
 #include "map.h"
 #include "player.h"
 
-void update_player(const u8 *keys)
+void update_player(keys_t keys)
 {
 	// Handle the key presses
 	g_map.player->obj.vel = (v2_vel_t) {0, 0};
@@ -11,33 +11,33 @@ void update_player(const u8 *keys)
 
 	// TODO: Change key detection order?
 	// Pause
-	if (keys[SDL_SCANCODE_ESCAPE]) {
+	if (KEY_PRESSED(keys, KEY_ESCAPE)) {
 		g_game.state = STATE_QUIT;
 		return;
 	}
 	// Run
-	if (keys[SDL_SCANCODE_A]) {
+	if (KEY_PRESSED(keys, KEY_RUN)) {
 		speed = Frac_CONVERT(scroll_t, vel_t, 8);
 	}
 	// Move left
-	if (keys[SDL_SCANCODE_LEFT]) {
+	if (KEY_PRESSED(keys, KEY_LEFT)) {
 		g_map.player->obj.vel.x = -speed;
 		g_map.player->obj.flip_x = true;
 	}
 	// Move right
-	if (keys[SDL_SCANCODE_RIGHT]) {
+	if (KEY_PRESSED(keys, KEY_RIGHT)) {
 		g_map.player->obj.vel.x = speed;
 		g_map.player->obj.flip_x = false;
 	}
 	// Jump/Swim
-	if (keys[SDL_SCANCODE_S]) {
+	if (KEY_PRESSED(keys, KEY_JUMP)) {
 	}
 	// Climb up/Look up
-	if (keys[SDL_SCANCODE_UP]) {
+	if (KEY_PRESSED(keys, KEY_UP)) {
 		g_map.player->obj.vel.y = -speed;
 	}
 	// Climb down/Crouch and look down
-	if (keys[SDL_SCANCODE_DOWN]) {
+	if (KEY_PRESSED(keys, KEY_DOWN)) {
 		g_map.player->obj.vel.y = speed;
 	}
 
@@ -56,9 +56,6 @@ void update_player(const u8 *keys)
 	// Stop the player if in collision with something else
 	tile_collision(&g_map.player->obj);
 
-	// Blargysplargh
-	obj_collision(&g_map.player->obj, &g_map.objects[0]);
-
 	// Wrap player around if map wraps AFTER collision
 	wrap_obj(&g_map.player->obj);
 }
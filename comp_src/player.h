@@ -4,6 +4,7 @@
 
 #include "common.h"
 #include "game.h"
+#include "input.h"
 #include "obj.h"
 #include "screen.h"
 
@@ -26,5 +27,5 @@ struct player
 	.extra_sprite.y = 1		\
 }
 
-// Update the player
-void update_player(const u8 *keys);
+// Update the player with the keys pressed this frame
+void update_player(keys_t keys);
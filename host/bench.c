@@ -0,0 +1,1566 @@
+// Super Grayland: Copyright 2021 Vincent Robinson under the zlib license.
+// See `license.txt` for more information.
+// Before delving into the code, please read `readme_source.txt` to understand the basic design.
+
+// Host frame-time benchmark
+/*
+	This program runs the calculator source on a computer through the tigcclib shim in this
+	directory. It plays scripted scroll patterns over the test map and over generated maps,
+	including one that the camera goes past the edges of, one that wraps, and one that is
+	streamed through a window of columns, on every
+	calculator model and reports the average time per frame that each phase of the level
+	mainloop takes, in nanoseconds. Every scenario is run once for each `SCR_BlitWidth`, and a
+	summary at the end shows which width blits fastest on each model. After the scenarios,
+	`MAP_getTile` is timed on each map that doesn't wrap, with and without a guard border,
+	along with `MAP_getCollision`, and then tile collision with and without the collision
+	grid. Last, the sorted list of map objects is timed at a thousand and ten thousand objects,
+	along with moving the objects by their velocities one at a time with `OBJ_addPosX/Y` and
+	all at once as active objects with `OBJ_moveActive`.
+	Finally, a scripted run through the level is recorded with the INP namespace, saved, and
+	replayed without a frame cap, reporting the total time and a histogram of frame times.
+
+	A dozen objects are drawn over the tiles every frame, moving across the screen and partly
+	off its edges with every combination of flips, and behind the foreground tiles in the maps.
+	They are in the level's object list along with objects standing still every few tiles over
+	the whole level, and are drawn with `GME_LVL_drawObjects` like in the game.
+
+	Every frame is also checked against a slow reference renderer that draws the map and the
+	objects pixel by pixel, so any optimization of the drawing code that changes what ends up on
+	the screen is caught immediately. Checking is not included in the timings. The temporary
+	tile and object sprites are written to sprite bank files first, with one object sprite made
+	opaque, so the game draws from banks read in place, just like on the calculator. Likewise,
+	the test map is written to a map file in the calculator's layout, which is checked and then
+	loaded by every scenario, and each map that doesn't wrap is given storage with
+	`MAP_initStorage` to check that only the long one is streamed. Before any of this,
+	`FXD_mult` and `FXD_div` are checked against 64 bit arithmetic, with every pair of 16 bit
+	numbers if `<filter>` is `fxd` and a sample of them otherwise.
+
+	Usage: `bench [-n <frames>] [<filter>]`, where `<frames>` is the number of frames to run
+	per scenario (default 2000) and `<filter>` only runs scenarios whose names contain it. The
+	program exits with a failure code if any scenario drew something wrong, leaked memory, did
+	not read the sprite bank file correctly, or couldn't stream a map that should be.
+*/
+
+// System headers must come before `common.h` poisons the words they use.
+#include <inttypes.h>
+#include <time.h>
+
+#include "../src/game.h"
+#include "../src/object.h"
+
+typedef uint64_t u64;
+typedef int64_t s64;
+
+extern const struct SCR_SpriteBank TEMP_TILE_BANK;
+extern const struct SCR_SpriteBank TEMP_OBJ_BANK;
+extern struct MAP_TileDef TEMP_DEFS[5];
+extern MAP_TileIndex TEMP_INDICES[40 * 20];
+
+// The phases of a frame that are timed, in order.
+enum Phase
+{
+	Phase_SCROLL,
+	Phase_ANIM,
+	Phase_BLIT,
+	Phase_OBJS,
+	Phase_SWAP,
+	Phase_LEN
+};
+
+const char *PHASE_NAMES[Phase_LEN] = {"scroll", "anim", "blit", "objs", "swap"};
+
+// A map to run a scenario on. `SizeX` and `SizeY` of zero use the map from `MAP_init`. The
+// camera can go `Overscan` tiles past the edges of the map, and the map wraps in both
+// directions with `Wrap`. Overscan must be small enough that the screen never goes more than
+// one map past the edges, since the reference renderer uses `MAP_getTile`. Maps with `Stream`
+// are streamed from the generated indices instead of being guarded.
+struct BenchMap
+{
+	const char *Name;
+	MAP_Pos SizeX;
+	MAP_Pos SizeY;
+	MAP_Pos Overscan;
+	enum MAP_Wrap Wrap;
+	bool Stream;
+};
+
+const struct BenchMap BENCH_MAPS[] = {
+	{"test", 0, 0, 0, MAP_Wrap_NONE},
+	{"wide", 1024, 32, 0, MAP_Wrap_NONE},
+	{"big", 256, 256, 0, MAP_Wrap_NONE},
+	{"edges", 48, 24, 6, MAP_Wrap_NONE},
+	{"wrap", 64, 40, 24, MAP_Wrap_LEVEL},
+	{"long", 4096, 24, 0, MAP_Wrap_NONE, TRUE},
+};
+
+// A scroll pattern. The camera starts a few pixels off the tile grid, moves with the velocity
+// in pixels per frame, and bounces off the edges of the map, stopping at them if the velocity
+// would take it past them. Every `TurnFrames` frames, the horizontal velocity reverses, and
+// every `EditFrames` frames, a random tile on the screen is changed and redrawn (zero for
+// never).
+struct Pattern
+{
+	const char *Name;
+	MAP_Scroll VelX;
+	MAP_Scroll VelY;
+	u16 TurnFrames;
+	u16 EditFrames;
+};
+
+const struct Pattern PATTERNS[] = {
+	{"idle", 0, 0, 0},
+	{"walk", 1, 0, 0},
+	{"run", 8, 0, 0},
+	{"fall", 0, 3, 0},
+	{"diagonal", 2, 1, 0},
+	{"zigzag", 4, 0, 24},
+	{"edit", 0, 0, 0, 3},
+	{"dash", 24, 8, 0, 0},
+	{"warp", 176, 104, 0, 0},
+};
+
+// Number of objects moving across the screen
+#define NUM_OBJS 12
+// Number of tiles between the objects standing still along the level
+#define STILL_OBJ_SPACING 4
+
+const char *CALC_NAMES[] = {"89", "92+", "", "V200"};
+const s16 CALCS[] = {TI89, V200};
+
+const char *WIDTH_NAMES[SCR_BlitWidth_LEN] = {"16", "32"};
+
+// Sum of the average blit times and number of scenarios for each calculator and blit width,
+// for the summary.
+u64 BlitSums[sizeof(CALC_NAMES) / sizeof(*CALC_NAMES)][SCR_BlitWidth_LEN];
+u16 BlitCounts[sizeof(CALC_NAMES) / sizeof(*CALC_NAMES)][SCR_BlitWidth_LEN];
+
+// Current time in nanoseconds.
+static u64 now(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (u64)time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+// Writes `bank` to a sprite bank file called `name` with mask info and, if `bank` has them,
+// animations.
+static void addBankFile(const char *name, const struct SCR_SpriteBank *bank)
+{
+	u16 num_sprites = bank->NumSprites;
+	size_t anims_size = bank->Anims != NULL ? num_sprites * sizeof(struct SCR_SpriteAnim) : 0;
+
+	struct SCR_BankHeader header = {
+		{'S', 'G', 'L', 'S'},
+		COM_be16(SCR_BANK_VERSION),
+		COM_be16(num_sprites),
+		COM_be16((bank->Anims != NULL ? SCR_BankFlag_ANIMS : 0) | SCR_BankFlag_MASK_INFO)
+	};
+
+	size_t size = sizeof(header) + anims_size + num_sprites * (1 + sizeof(SCR_SpriteBuffer));
+	u8 *file = malloc(size);
+	u8 *it = file;
+
+	memcpy(it, &header, sizeof(header));
+	it += sizeof(header);
+
+	if (bank->Anims != NULL)
+		memcpy(it, bank->Anims, anims_size);
+	it += anims_size;
+
+	for (u16 i = 0; i < num_sprites; i++) {
+		const SCR_SpriteBuffer *sprite = &bank->Sprites[i];
+		bool opaque = TRUE;
+		bool clear = TRUE;
+
+		for (u16 row = 0; row < SCR_SPRITE_SIZE; row++) {
+			opaque &= (*sprite)[SCR_SPRITE_MASK][row] == 0x00;
+			clear &= (*sprite)[SCR_SPRITE_MASK][row] == 0xFF &&
+					(*sprite)[SCR_SPRITE_DARK][row] == 0 && (*sprite)[SCR_SPRITE_LIGHT][row] == 0;
+		}
+
+		*it++ = (opaque ? SCR_MaskInfo_OPAQUE : 0) | (clear ? SCR_MaskInfo_CLEAR : 0);
+	}
+
+	memcpy(it, bank->Sprites, num_sprites * sizeof(SCR_SpriteBuffer));
+
+	HostAddFile(name, "sgls", file, size);
+	free(file);
+}
+
+// Returns TRUE unless `bank` was read from its file and matches `expected`.
+static bool checkBank(const struct SCR_SpriteBank *bank, const struct SCR_SpriteBank *expected)
+{
+	return bank->File.dataH == H_NULL || bank->NumSprites != expected->NumSprites ||
+			bank->MaskInfo == NULL || (bank->Anims == NULL) != (expected->Anims == NULL) ||
+			memcmp(bank->Sprites, expected->Sprites,
+					bank->NumSprites * sizeof(SCR_SpriteBuffer)) != 0 ||
+			(bank->Anims != NULL && memcmp(bank->Anims, expected->Anims,
+					bank->NumSprites * sizeof(struct SCR_SpriteAnim)) != 0);
+}
+
+// The object bank that the bench writes, which is the temporary one except that the tester's
+// first frame is made opaque so that drawing opaque sprites is checked too.
+SCR_SpriteBuffer BenchObjSprites[64];
+struct SCR_SpriteBank BenchObjBank;
+
+static void initBenchObjBank(void)
+{
+	BenchObjBank = TEMP_OBJ_BANK;
+	memcpy(BenchObjSprites, TEMP_OBJ_BANK.Sprites,
+			TEMP_OBJ_BANK.NumSprites * sizeof(SCR_SpriteBuffer));
+	memset(BenchObjSprites[0][SCR_SPRITE_MASK], 0, SCR_SPRITE_SIZE);
+	BenchObjBank.Sprites = BenchObjSprites;
+}
+
+// Contents of the test map's file apart from its tiles
+#define MAP_FILE_NAME "Test Level"
+#define MAP_FILE_TEXT "Hey presto!"
+
+const struct MAP_Obj MAP_FILE_OBJS[3] = {
+	{COM_be16(2), COM_be16(18), OBJ_Type_GRAYFORD, 0, 0, 0},
+	{COM_be16(12), COM_be16(13), OBJ_Type_TESTER, 1, 2, MAP_ObjFlag_FLIP_X},
+	{COM_be16(30), COM_be16(9), OBJ_Type_SUPER_GRAYFORD, 3, 4, MAP_ObjFlag_FLIP_Y}
+};
+
+// Writes the test map to a map file called `name` with a player, a couple of objects, a
+// special, and text, converting it to the calculator's layout like a level editor would.
+static void addMapFile(const char *name)
+{
+	u16 num_defs = sizeof(TEMP_DEFS) / sizeof(*TEMP_DEFS);
+	u16 num_tiles = sizeof(TEMP_INDICES);
+	u16 name_len = strlen(MAP_FILE_NAME);
+	u16 text_size = strlen(MAP_FILE_TEXT);
+
+	struct MAP_FileHeader header = {
+		{'S', 'G', 'L', 'M'},
+		COM_be16(MAP_FILE_VERSION),
+		COM_be16(40),
+		COM_be16(20),
+		COM_be16(num_defs),
+		COM_be16(2),
+		COM_be16(1),
+		COM_be16(text_size),
+		name_len, 3, 7, MAP_FileFlag_RAIN, MAP_Wrap_NONE, MAP_Wrap_NONE
+	};
+
+	// Odd sections are padded, which `calloc` leaves as zeros.
+	size_t size = sizeof(header) + num_defs * sizeof(struct MAP_TileDef) +
+			((num_tiles + 1) & ~1) + sizeof(MAP_FILE_OBJS) + MAP_SPECIAL_SIZE +
+			((name_len + 1) & ~1) + text_size;
+	u8 *file = calloc(size, 1);
+	u8 *it = file;
+
+	memcpy(it, &header, sizeof(header));
+	it += sizeof(header);
+
+	for (u16 i = 0; i < num_defs; i++) {
+		const struct MAP_TileDef *def = &TEMP_DEFS[i];
+
+		*it++ = def->Back >> 8;
+		*it++ = def->Back & 0xFF;
+		*it++ = def->Front >> 8;
+		*it++ = def->Front & 0xFF;
+		*it++ = def->Special;
+		*it++ = def->Collision << 6 | def->Property << 3 | def->IsBackFg << 2 |
+				def->IsFrontFg << 1;
+	}
+
+	memcpy(it, TEMP_INDICES, num_tiles);
+	it += (num_tiles + 1) & ~1;
+
+	memcpy(it, MAP_FILE_OBJS, sizeof(MAP_FILE_OBJS));
+	it += sizeof(MAP_FILE_OBJS);
+
+	memset(it, 0xA5, MAP_SPECIAL_SIZE);
+	it += MAP_SPECIAL_SIZE;
+
+	memcpy(it, MAP_FILE_NAME, name_len);
+	it += (name_len + 1) & ~1;
+
+	memcpy(it, MAP_FILE_TEXT, text_size);
+
+	HostAddFile(name, "sglm", file, size);
+	free(file);
+}
+
+// Loads the map file called `name` and prints whether it matches the test map that
+// `addMapFile` wrote. Returns TRUE if it doesn't or memory leaked.
+static bool checkMapFile(const char *name)
+{
+	u32 initial_mem = HeapAvail();
+
+	struct MAP_Map map;
+	COM_zero(&map);
+	MAP_init(&map, name);
+
+	bool wrong = map.File.dataH == H_NULL || map.SizeX != 40 || map.SizeY != 20 ||
+			map.NumDefs != sizeof(TEMP_DEFS) / sizeof(*TEMP_DEFS) ||
+			memcmp(map.Indices, TEMP_INDICES, sizeof(TEMP_INDICES)) != 0 ||
+			map.NumObjs != 2 || memcmp(map.Player, MAP_FILE_OBJS, sizeof(MAP_FILE_OBJS)) != 0 ||
+			map.NumSpecials != 1 || map.Specials[0] != 0xA5 ||
+			map.Specials[MAP_SPECIAL_SIZE - 1] != 0xA5 ||
+			map.NameLength != strlen(MAP_FILE_NAME) ||
+			memcmp(map.Name, MAP_FILE_NAME, map.NameLength) != 0 ||
+			map.TextSize != strlen(MAP_FILE_TEXT) ||
+			memcmp(map.Text, MAP_FILE_TEXT, map.TextSize) != 0 ||
+			map.Act != 3 || map.Music != 7 || !map.UseRain;
+
+	for (u16 i = 0; !wrong && i < map.NumDefs; i++) {
+		const struct MAP_TileDef *def = &map.Defs[i];
+		const struct MAP_TileDef *expected = &TEMP_DEFS[i];
+
+		wrong |= def->Back != expected->Back || def->Front != expected->Front ||
+				def->Special != expected->Special || def->Collision != expected->Collision ||
+				def->Property != expected->Property || def->IsBackFg != expected->IsBackFg ||
+				def->IsFrontFg != expected->IsFrontFg;
+	}
+
+	// Tiles in the file can't be changed until the map is guarded, which copies them, and the
+	// file stays as it was either way.
+	MAP_TileIndex first = map.Indices[0];
+	wrong |= !MAP_setTile(&map, 0, 0, first + 1) || map.Indices[0] != first;
+	wrong |= MAP_initGuard(&map) || MAP_setTile(&map, 0, 0, first + 1) ||
+			map.Indices[0] != first + 1 || map.PlainIndices[0] != first;
+
+	MAP_deInit(&map);
+
+	bool leaked = HeapAvail() != initial_mem;
+
+	printf("Map file: %s%s\n\n", wrong ? "WRONG" : "read correctly", leaked ? "  LEAK" : "");
+	return wrong || leaked;
+}
+
+// Reference fixed point arithmetic for `checkFixedPoint`, done in 64 bits and then truncated
+// to 32 bits like `FXD_mult` and `FXD_div`
+#define refMult(point, num1, num2) ((s32)(u32)(((s64)(num1) * (num2)) >> (point)))
+#define refDiv(point, num1, num2) ((s32)(u32)(((s64)(num1) * ((s64)1 << (point))) / (num2)))
+
+// Checks one product and quotient of each fixed point type in `checkFixedPoint`.
+#define checkArith(type, num1, num2)											\
+({																				\
+	type _a = (num1);															\
+	type _b = (num2);															\
+	bool _wrong = FXD_mult(type, _a, _b) != refMult(type##_POINT, _a, _b);		\
+	if (_b != 0)																\
+		_wrong |= FXD_div(type, _a, _b) != refDiv(type##_POINT, _a, _b);			\
+	_wrong;																		\
+})
+
+// Edge cases for 32 bit arithmetic, which are checked against each other
+const s32 FIXED_EDGES[] = {0, 1, -1, 2, -2, 255, 256, -256, 257, 32767, -32768, 32768, 65535,
+		65536, -65536, 65537, 0x7FFFFF, 0x800000, -0x800000, 0x7FFFFFFF, -0x7FFFFFFF - 1,
+		0x12345678, -0x12345678};
+
+// Checks `FXD_mult` and `FXD_div` against 64 bit arithmetic, with every pair of 16 bit numbers
+// if `exhaustive` or every 16 bit number against every 257th otherwise, along with edge cases
+// and random 32 bit numbers mixed with 16 bit ones. Returns TRUE if any result is wrong.
+static bool checkFixedPoint(bool exhaustive)
+{
+	bool wrong = FALSE;
+	u64 checked = 0;
+	u16 stride = exhaustive ? 1 : 257;
+
+	for (s32 a = -32768; a <= 32767; a++) {
+		for (s32 b = -32768; b <= 32767; b += stride) {
+			wrong |= checkArith(s16, a, b);
+			wrong |= checkArith(SCR_Pixel, a, b);
+			wrong |= checkArith(OBJ_Vel, a, b);
+			checked += 3;
+		}
+	}
+
+	for (u16 i = 0; i < sizeof(FIXED_EDGES) / sizeof(*FIXED_EDGES); i++) {
+		for (u16 j = 0; j < sizeof(FIXED_EDGES) / sizeof(*FIXED_EDGES); j++) {
+			wrong |= checkArith(s32, FIXED_EDGES[i], FIXED_EDGES[j]);
+			wrong |= checkArith(OBJ_Pos, FIXED_EDGES[i], FIXED_EDGES[j]);
+			checked += 2;
+		}
+	}
+
+	// Positions times velocities and positions times positions
+	u32 seed = 31337;
+	for (u32 i = 0; i < 1000000; i++) {
+		seed = seed * 1103515245 + 12345;
+		OBJ_Pos pos = (OBJ_Pos)(seed ^ (seed << 16));
+		seed = seed * 1103515245 + 12345;
+		OBJ_Pos other = (OBJ_Pos)(seed ^ (seed << 15)) >> (seed % 24);
+		OBJ_Vel vel = (OBJ_Vel)(seed >> 16);
+
+		wrong |= FXD_mult(OBJ_Pos, pos, vel) != refMult(OBJ_Pos_POINT, pos, vel);
+		wrong |= FXD_mult(OBJ_Pos, vel, pos) != refMult(OBJ_Pos_POINT, vel, pos);
+		wrong |= checkArith(OBJ_Pos, pos, other);
+		wrong |= checkArith(s32, pos, other);
+		if (vel != 0)
+			wrong |= FXD_div(OBJ_Pos, pos, vel) != refDiv(OBJ_Pos_POINT, pos, vel);
+		checked += 5;
+	}
+
+	printf("Fixed point: checked %" PRIu64 " products and quotients%s\n", checked,
+			wrong ? "  WRONG" : "");
+	return wrong;
+}
+
+// Fill a map with deterministic random tiles from `TEMP_DEFS`, which is mostly air with some
+// platforms, crosses, and animated sparkles, roughly like a real level.
+static void generateMap(MAP_TileIndex *indices, MAP_Pos size_x, MAP_Pos size_y)
+{
+	u32 seed = 12345;
+
+	for (s32 i = 0; i < (s32)size_x * size_y; i++) {
+		seed = seed * 1103515245 + 12345;
+
+		u16 roll = (seed >> 16) % 16;
+		indices[i] = roll < 11 ? 0 : roll < 13 ? 1 : roll < 14 ? 3 : roll < 15 ? 4 : 2;
+	}
+}
+
+// Changes a deterministic random tile on the screen to the next tile definition and redraws it
+// to the tile buffer, like a tile that was broken.
+static void editTile(struct SCR_Screen *screen, struct MAP_Map *map, u32 *seed)
+{
+	*seed = *seed * 1103515245 + 12345;
+	u16 x = (*seed >> 16) % SCR_SPRITES_X;
+	*seed = *seed * 1103515245 + 12345;
+	u16 y = (*seed >> 16) % SCR_SPRITES_Y;
+
+	MAP_Pos tile_x = FXD_convert(MAP_Scroll, MAP_Pos, map->ScrollX) + x;
+	MAP_Pos tile_y = FXD_convert(MAP_Scroll, MAP_Pos, map->ScrollY) + y;
+
+	// Tiles off the edges of the map can't be changed, but they wrap around to tiles that can.
+	const struct MAP_TileDef *tile = MAP_getTile(map, tile_x, tile_y);
+	if (tile < map->Defs || tile >= map->Defs + map->NumDefs)
+		return;
+
+	MAP_Pos wrapped_x = (tile_x + map->SizeX) % map->SizeX;
+	MAP_Pos wrapped_y = (tile_y + map->SizeY) % map->SizeY;
+
+	MAP_setTile(map, wrapped_x, wrapped_y, (*MAP_getIndex(map, wrapped_x, wrapped_y) + 1) %
+			map->NumDefs);
+
+	SCR_TB_drawTile(screen, MAP_getTile(map, tile_x, tile_y), SCR_TB_getOffset(screen, x, y));
+}
+
+// Returns TRUE if the collision grid is missing or doesn't match the tiles. Streamed maps are
+// only checked in the window, which is the only place the tiles are.
+static bool checkCollisions(const struct MAP_Map *map)
+{
+	if (map->Collisions == NULL)
+		return TRUE;
+
+	MAP_Pos first = map->Window != NULL ? map->WindowX : 0;
+	MAP_Pos end = map->Window != NULL ? first + MAP_WINDOW_WIDTH : map->SizeX;
+
+	for (MAP_Pos y = 0; y < map->SizeY; y++) {
+		for (MAP_Pos x = first; x < end; x++) {
+			if (MAP_getCollision(map, x, y) != MAP_getTile(map, x, y)->Collision)
+				return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+// Returns `scroll` moved into a level that wraps and is `size` tiles long.
+static MAP_Scroll wrapScroll(MAP_Scroll scroll, MAP_Pos size)
+{
+	MAP_Scroll length = size * SCR_SPRITE_SIZE;
+	scroll %= length;
+	return scroll < 0 ? scroll + length : scroll;
+}
+
+// Places the objects for a frame. They move across the screen at different speeds, so they
+// keep going partly off every edge of it, and cover every type, flip, and animation frame.
+// They are the first `NUM_OBJS` objects in `objs`, which is kept sorted.
+static void placeObjects(struct OBJ_Objects *objs, const struct MAP_Map *map, u16 frame)
+{
+	for (u16 i = 0; i < NUM_OBJS; i++) {
+		struct OBJ_Object new_obj;
+		struct OBJ_Object *obj = &new_obj;
+		COM_zero(obj);
+
+		MAP_Scroll x = map->ScrollX + (i * 37 + frame * (i % 3 + 1)) % (SCR_WIDTH + 24) - 16;
+		MAP_Scroll y = map->ScrollY + (i * 29 + frame * (i % 2 + 1)) % (SCR_GAME_HEIGHT + 24);
+
+		// Objects in levels that wrap stay inside the level, so the ones near the camera may
+		// only be seen across an edge.
+		if (map->WrapX == MAP_Wrap_LEVEL)
+			x = wrapScroll(x, map->SizeX);
+		if (map->WrapY == MAP_Wrap_LEVEL)
+			y = wrapScroll(y, map->SizeY);
+
+		// Multiplying instead of converting, since `x` may be negative.
+		obj->PosX = x * (FXD_denom(OBJ_Pos) / FXD_denom(MAP_Scroll));
+		obj->PosY = y * (FXD_denom(OBJ_Pos) / FXD_denom(MAP_Scroll));
+
+		obj->Type = i % OBJ_Type_LEN;
+		if (obj->Type != OBJ_Type_SUPER_GRAYFORD)
+			obj->SpriteOffset = (frame / 4 + i) % 2;
+
+		obj->FlipAcrossX = i & 1;
+		obj->FlipAcrossY = (i >> 1) & 1;
+
+		// The object may be active, so its position is set apart from the rest of it.
+		OBJ_Pos pos_x = obj->PosX;
+		OBJ_Pos pos_y = obj->PosY;
+		obj->PosX = objs->List.Items[i].PosX;
+		objs->List.Items[i] = *obj;
+		OBJ_setPosX(objs, i, pos_x);
+		OBJ_setPosY(objs, i, pos_y);
+	}
+}
+
+// Replaces the objects of the level with `NUM_OBJS` objects for `placeObjects` and objects
+// standing still every `STILL_OBJ_SPACING` tiles along it.
+static void initObjects(struct GME_Level *level)
+{
+	struct OBJ_Objects *objs = &level->Objs;
+	u16 num_still = level->Map.SizeX / STILL_OBJ_SPACING;
+
+	OBJ_deInit(objs);
+	OBJ_init(objs, NUM_OBJS + num_still, GME_LVL_MAX_ACTIVE);
+
+	struct OBJ_Object obj;
+	COM_zero(&obj);
+
+	u16 last = SLL_NULL;
+	for (u16 i = 0; i < NUM_OBJS; i++)
+		last = SLL_OBJ_Object_add(&objs->List, &obj, last);
+
+	obj.Type = OBJ_Type_TESTER;
+	for (u16 i = 0; i < num_still; i++) {
+		obj.PosX = FXD_convert(MAP_Pos, OBJ_Pos, (MAP_Pos)(i * STILL_OBJ_SPACING + 1));
+		obj.PosY = FXD_convert(MAP_Pos, OBJ_Pos, (MAP_Pos)(i * 7 % level->Map.SizeY + 1));
+		last = SLL_OBJ_Object_add(&objs->List, &obj, last);
+	}
+
+	level->DrawFirst = objs->List.Base.First;
+}
+
+// Returns the sprite of the current animation frame of `sprite`.
+static u16 animSprite(const struct SCR_Screen *screen, u16 sprite)
+{
+	const struct SCR_SpriteAnim *anim = &screen->TileBank.Anims[sprite];
+	return sprite + screen->AnimTick / anim->Rate % anim->Frames;
+}
+
+// Compares the game area of the hidden gray planes against what the map and `objs` should
+// look like at the current scroll position. Returns TRUE if anything differs.
+static bool checkScreen(const struct SCR_Screen *screen, const struct MAP_Map *map,
+		const struct OBJ_Objects *objs)
+{
+	static u8 expected[2][SCR_GAME_HEIGHT][SCR_WIDTH];
+	static u8 foreground[SCR_GAME_HEIGHT][SCR_WIDTH];
+
+	const SCR_SpriteBuffer *tiles = screen->TileBank.Sprites;
+	const SCR_SpriteBuffer *obj_sprites = screen->ObjBank.Sprites;
+
+	for (s16 y = 0; y < SCR_GAME_HEIGHT; y++) {
+		for (s16 x = 0; x < SCR_WIDTH; x++) {
+			MAP_Scroll world_x = map->ScrollX + x;
+			MAP_Scroll world_y = map->ScrollY + y;
+
+			const struct MAP_TileDef *tile = MAP_getTile(map,
+					FXD_convert(MAP_Scroll, MAP_Pos, world_x),
+					FXD_convert(MAP_Scroll, MAP_Pos, world_y));
+
+			u16 row = FXD_numer(MAP_Scroll, world_y);
+			u8 bit = 0x80 >> FXD_numer(MAP_Scroll, world_x);
+
+			u16 back = animSprite(screen, tile->Back);
+			u16 front = animSprite(screen, tile->Front);
+
+			foreground[y][x] = tile->IsBackFg ||
+					(tile->IsFrontFg && !(tiles[front][SCR_SPRITE_MASK][row] & bit));
+
+			for (u16 plane = 0; plane < 2; plane++) {
+				u16 sprite = plane == 0 ? SCR_SPRITE_DARK : SCR_SPRITE_LIGHT;
+
+				u8 pixels = (tiles[back][sprite][row] & tiles[front][SCR_SPRITE_MASK][row]) |
+						tiles[front][sprite][row];
+				expected[plane][y][x] = (pixels & bit) != 0;
+			}
+		}
+	}
+
+	// Every object is drawn in the order of the list over the tiles, flipping each pixel of the
+	// whole object, and behind foreground tiles.
+	for (u16 i = objs->List.Base.First; i != SLL_NULL; i = objs->List.Base.Links[i].Right) {
+		struct OBJ_Object obj_copy;
+		const struct OBJ_Object *obj = &obj_copy;
+		OBJ_get(objs, i, &obj_copy);
+		const struct OBJ_ObjectDef *def = OBJ_getDef(obj->Type);
+
+		u16 width = (def->ExtraWidth + 1) * SCR_SPRITE_SIZE;
+		u16 height = (def->ExtraHeight + 1) * SCR_SPRITE_SIZE;
+		u16 frame = def->Sprite + obj->SpriteOffset * (def->ExtraWidth + 1) *
+				(def->ExtraHeight + 1);
+
+		s32 obj_left = FXD_convert(OBJ_Pos, MAP_Scroll, obj->PosX) - map->ScrollX;
+		s32 obj_top = FXD_convert(OBJ_Pos, MAP_Scroll, obj->PosY) - map->ScrollY - height;
+
+		// In levels that wrap, copies a level away are drawn too.
+		s16 wrap_x = map->WrapX == MAP_Wrap_LEVEL;
+		s16 wrap_y = map->WrapY == MAP_Wrap_LEVEL;
+		s32 level_x = map->SizeX * SCR_SPRITE_SIZE;
+		s32 level_y = map->SizeY * SCR_SPRITE_SIZE;
+		for (s16 copy = 0; copy < (2 * wrap_x + 1) * (2 * wrap_y + 1); copy++) {
+			s32 left = obj_left + (copy % (2 * wrap_x + 1) - wrap_x) * level_x;
+			s32 top = obj_top + (copy / (2 * wrap_x + 1) - wrap_y) * level_y;
+			if (left >= SCR_WIDTH || left + width <= 0 || top >= SCR_GAME_HEIGHT ||
+					top + height <= 0)
+				continue;
+
+			for (u16 obj_y = 0; obj_y < height; obj_y++) {
+				for (u16 obj_x = 0; obj_x < width; obj_x++) {
+					s32 x = left + obj_x;
+					s32 y = top + obj_y;
+					if (x < 0 || x >= SCR_WIDTH || y < 0 || y >= SCR_GAME_HEIGHT ||
+							foreground[y][x])
+						continue;
+
+					u16 src_x = obj->FlipAcrossX ? width - 1 - obj_x : obj_x;
+					u16 src_y = obj->FlipAcrossY ? height - 1 - obj_y : obj_y;
+
+					const SCR_SpriteBuffer *sprite = &obj_sprites[frame + src_y /
+							SCR_SPRITE_SIZE * (def->ExtraWidth + 1) + src_x / SCR_SPRITE_SIZE];
+					u16 row = src_y % SCR_SPRITE_SIZE;
+					u8 bit = 0x80 >> (src_x % SCR_SPRITE_SIZE);
+
+					if ((*sprite)[SCR_SPRITE_MASK][row] & bit)
+						continue;
+
+					expected[0][y][x] = ((*sprite)[SCR_SPRITE_DARK][row] & bit) != 0;
+					expected[1][y][x] = ((*sprite)[SCR_SPRITE_LIGHT][row] & bit) != 0;
+				}
+			}
+		}
+	}
+
+	const u8 *planes[2] = {GrayDBufGetHiddenPlane(DARK_PLANE),
+			GrayDBufGetHiddenPlane(LIGHT_PLANE)};
+
+	u16 base = SCR_SCREEN_BUFFER_WIDTH * SCR_HUD_HEIGHT;
+	if (SCR_isLargeScreen())
+		base += SCR_LARGE_OFFSET_BYTES;
+
+	for (s16 y = 0; y < SCR_GAME_HEIGHT; y++) {
+		for (s16 x = 0; x < SCR_WIDTH; x++) {
+			for (u16 plane = 0; plane < 2; plane++) {
+				u8 actual = planes[plane][base + y * SCR_SCREEN_BUFFER_WIDTH + x / 8] <<
+						(x % 8);
+
+				if (expected[plane][y][x] != ((actual & 0x80) != 0))
+					return TRUE;
+			}
+		}
+	}
+
+	return FALSE;
+}
+
+// Runs a single pattern over a single map on a single calculator with a single blit width and
+// prints the results. Returns TRUE if the screen was ever drawn wrong or memory leaked.
+static bool runScenario(const struct BenchMap *bench_map, const struct Pattern *pattern,
+		s16 calc, enum SCR_BlitWidth width, u16 frames)
+{
+	HostCalculator = calc;
+
+	u32 initial_mem = HeapAvail();
+
+	struct GME_Game game;
+	COM_zero(&game);
+
+	GME_init(&game);
+
+	struct SCR_Screen *screen = &game.Screen;
+	struct MAP_Map *map = &game.Level.Map;
+
+	screen->BlitWidth = width;
+
+	bool bad_bank = checkBank(&screen->TileBank, &TEMP_TILE_BANK) ||
+			checkBank(&screen->ObjBank, &BenchObjBank);
+
+	// The map is always copied since the edit pattern changes it. The level's guarded copy
+	// and collision grid of the test map are remade from the copy.
+	MAP_deInitGuard(map);
+	MAP_deInitCollisions(map);
+
+	MAP_TileIndex *indices;
+	if (bench_map->SizeX != 0) {
+		indices = malloc((size_t)bench_map->SizeX * bench_map->SizeY);
+		generateMap(indices, bench_map->SizeX, bench_map->SizeY);
+
+		map->SizeX = bench_map->SizeX;
+		map->SizeY = bench_map->SizeY;
+		map->WrapX = map->WrapY = bench_map->Wrap;
+	} else {
+		indices = malloc((size_t)map->SizeX * map->SizeY);
+		memcpy(indices, map->Indices, (size_t)map->SizeX * map->SizeY);
+	}
+
+	map->Indices = indices;
+	map->Pitch = map->SizeX;
+	map->ReadOnly = FALSE;
+
+	bool bad_stream = FALSE;
+	if (bench_map->Stream)
+		bad_stream = MAP_initStream(map);
+	else
+		MAP_initGuard(map);
+	MAP_initCollisions(map);
+
+	SCR_TB_initLevel(screen, map);
+	SCR_scrollAbsolute(screen, map, 19, 13);
+	initObjects(&game.Level);
+
+	u32 seed = 54321;
+
+	// The furthest the camera can scroll while keeping the screen inside the map and overscan.
+	MAP_Scroll min_pos = -bench_map->Overscan * FXD_denom(MAP_Scroll);
+	MAP_Scroll max_x = FXD_convert(MAP_Pos, MAP_Scroll,
+			map->SizeX - SCR_SPRITES_X + bench_map->Overscan);
+	MAP_Scroll max_y = FXD_convert(MAP_Pos, MAP_Scroll,
+			map->SizeY - SCR_SPRITES_Y + bench_map->Overscan);
+
+	MAP_Scroll vel_x = pattern->VelX;
+	MAP_Scroll vel_y = pattern->VelY;
+
+	u64 totals[Phase_LEN] = {0};
+	u64 frame_min = (u64)-1;
+	u64 frame_max = 0;
+	s32 bad_frame = -1;
+
+	for (u16 frame = 0; frame < frames; frame++) {
+		if (pattern->TurnFrames != 0 && frame % pattern->TurnFrames == 0 && frame != 0)
+			vel_x = -vel_x;
+
+		if (map->ScrollX + vel_x < min_pos || map->ScrollX + vel_x > max_x)
+			vel_x = -vel_x;
+		if (map->ScrollY + vel_y < min_pos || map->ScrollY + vel_y > max_y)
+			vel_y = -vel_y;
+
+		MAP_Scroll shift_x =
+				COM_min(COM_max(map->ScrollX + vel_x, min_pos), max_x) - map->ScrollX;
+		MAP_Scroll shift_y =
+				COM_min(COM_max(map->ScrollY + vel_y, min_pos), max_y) - map->ScrollY;
+
+		if (pattern->EditFrames != 0 && frame % pattern->EditFrames == 0)
+			editTile(screen, map, &seed);
+
+		u64 frame_time = 0;
+
+	// Run `code`, adding the time it took to the phase and the frame.
+	#define timePhase(phase, code)				\
+	({											\
+		u64 _start = now();						\
+		code;									\
+		u64 _elapsed = now() - _start;			\
+		totals[phase] += _elapsed;				\
+		frame_time += _elapsed;					\
+	})
+
+		// This mirrors `GME_LVL_loop`.
+		timePhase(Phase_SCROLL, SCR_scroll(screen, map, shift_x, shift_y));
+		timePhase(Phase_ANIM, SCR_TB_updateAnimatedTiles(screen));
+		timePhase(Phase_BLIT, SCR_drawTileBuffer(screen,
+				FXD_numer(MAP_Scroll, map->ScrollX), FXD_numer(MAP_Scroll, map->ScrollY)));
+
+		// The objects don't move by themselves, but updating them makes the ones around the
+		// screen active, so they are drawn from the active arrays.
+		placeObjects(&game.Level.Objs, map, frame);
+		GME_LVL_updateObjects(&game.Level);
+		timePhase(Phase_OBJS, GME_LVL_drawObjects(screen, &game.Level));
+
+		if (bad_frame < 0 && checkScreen(screen, map, &game.Level.Objs))
+			bad_frame = frame;
+
+		timePhase(Phase_SWAP, SCR_swap());
+
+	#undef timePhase
+
+		frame_min = COM_min(frame_min, frame_time);
+		frame_max = COM_max(frame_max, frame_time);
+	}
+
+	bool bad_grid = checkCollisions(map);
+
+	GME_deInit(&game);
+	free(indices);
+
+	bool leaked = HeapAvail() != initial_mem;
+
+	BlitSums[calc][width] += totals[Phase_BLIT] / frames;
+	BlitCounts[calc][width]++;
+
+	printf("%-6s %-9s %-5s %-5s", bench_map->Name, pattern->Name, CALC_NAMES[calc],
+			WIDTH_NAMES[width]);
+	u64 frame_total = 0;
+	for (u16 phase = 0; phase < Phase_LEN; phase++) {
+		printf(" %8" PRIu64, totals[phase] / frames);
+		frame_total += totals[phase];
+	}
+	printf(" %8" PRIu64 " %8" PRIu64 " %8" PRIu64, frame_total / frames, frame_min, frame_max);
+
+	if (bad_frame >= 0)
+		printf("  WRONG (frame %" PRId32 ")", bad_frame);
+	if (leaked)
+		printf("  LEAK");
+	if (bad_bank)
+		printf("  BANK");
+	if (bad_stream)
+		printf("  STREAM");
+	if (bad_grid)
+		printf("  GRID");
+	printf("\n");
+
+	return bad_frame >= 0 || leaked || bad_bank || bad_stream || bad_grid;
+}
+
+// Number of positions `runLookups` looks up
+#define NUM_LOOKUPS 4096
+
+// Loads the test map, or generates `bench_map` into `indices` and uses it instead. `indices`
+// must be freed after deinitializing the map.
+static void initBenchMap(struct MAP_Map *map, const struct BenchMap *bench_map,
+		MAP_TileIndex **indices)
+{
+	COM_zero(map);
+	MAP_init(map, "sgl\\level");
+
+	*indices = NULL;
+	if (bench_map->SizeX != 0) {
+		*indices = malloc((size_t)bench_map->SizeX * bench_map->SizeY);
+		generateMap(*indices, bench_map->SizeX, bench_map->SizeY);
+
+		map->Indices = *indices;
+		map->ReadOnly = FALSE;
+		map->SizeX = map->Pitch = bench_map->SizeX;
+		map->SizeY = bench_map->SizeY;
+	}
+}
+
+// Gives each map that doesn't wrap storage with `MAP_initStorage` and prints which kind it got.
+// Returns TRUE if a map that should be streamed is guarded or the other way around, or if
+// memory leaked.
+static bool checkStorage(void)
+{
+	u32 initial_mem = HeapAvail();
+	bool wrong = FALSE;
+
+	printf("Map storage:");
+	for (u16 m = 0; m < sizeof(BENCH_MAPS) / sizeof(*BENCH_MAPS); m++) {
+		const struct BenchMap *bench_map = &BENCH_MAPS[m];
+		if (bench_map->Wrap)
+			continue;
+
+		struct MAP_Map map;
+		MAP_TileIndex *indices;
+		initBenchMap(&map, bench_map, &indices);
+
+		bool failed = MAP_initStorage(&map);
+		printf(" %s %s", bench_map->Name, map.Window != NULL ? "streamed" : "guarded");
+		wrong |= failed || (map.Window != NULL) != bench_map->Stream ||
+				(map.Rows != NULL) == bench_map->Stream;
+
+		MAP_deInit(&map);
+		free(indices);
+	}
+
+	bool leaked = HeapAvail() != initial_mem;
+	printf("%s%s\n\n", wrong ? "  WRONG" : "", leaked ? "  LEAK" : "");
+	return wrong || leaked;
+}
+
+// Times `MAP_getTile` at positions in and just around the map, like the points that objects
+// check, with the map unguarded and then guarded, and then `MAP_getCollision` with the
+// collision grid, and prints the time per thousand lookups. Returns TRUE if they ever give
+// different tiles or `MAP_findCollision` finds a different tile than checking one by one.
+static bool runLookups(const struct BenchMap *bench_map, u16 rounds)
+{
+	struct MAP_Map map;
+	MAP_TileIndex *indices;
+	initBenchMap(&map, bench_map, &indices);
+
+	static MAP_Pos xs[NUM_LOOKUPS], ys[NUM_LOOKUPS];
+	static struct MAP_TileDef plain[NUM_LOOKUPS];
+
+	u32 seed = 777;
+	for (u16 i = 0; i < NUM_LOOKUPS; i++) {
+		seed = seed * 1103515245 + 12345;
+		xs[i] = (MAP_Pos)((seed >> 16) % (map.SizeX + 4)) - 2;
+		seed = seed * 1103515245 + 12345;
+		ys[i] = (MAP_Pos)((seed >> 16) % (map.SizeY + 4)) - 2;
+
+		plain[i] = *MAP_getTile(&map, xs[i], ys[i]);
+	}
+
+	u64 times[3];
+	bool wrong = FALSE;
+
+	for (u16 pass = 0; pass < 3; pass++) {
+		if ((pass == 1 && MAP_initGuard(&map)) || (pass == 2 && MAP_initCollisions(&map)))
+			return TRUE;
+
+		// Summing the collision keeps the lookups from being optimized out.
+		volatile u16 sink = 0;
+		u64 start = now();
+
+		for (u16 round = 0; round < rounds; round++) {
+			u16 sum = 0;
+			if (pass < 2) {
+				for (u16 i = 0; i < NUM_LOOKUPS; i++)
+					sum += MAP_getTile(&map, xs[i], ys[i])->Collision;
+			} else {
+				for (u16 i = 0; i < NUM_LOOKUPS; i++)
+					sum += MAP_getCollision(&map, xs[i], ys[i]);
+			}
+			sink += sum;
+		}
+
+		times[pass] = (now() - start) * 1000 / ((u64)rounds * NUM_LOOKUPS);
+	}
+
+	for (u16 i = 0; i < NUM_LOOKUPS; i++) {
+		const struct MAP_TileDef *tile = MAP_getTile(&map, xs[i], ys[i]);
+
+		wrong |= tile->Back != plain[i].Back || tile->Front != plain[i].Front ||
+				tile->Collision != plain[i].Collision || tile->Property != plain[i].Property ||
+				MAP_getCollision(&map, xs[i], ys[i]) != plain[i].Collision;
+	}
+
+	// Spans of every length up to a few bytes of the grid, starting anywhere near the map
+	for (u16 i = 0; i < NUM_LOOKUPS; i++) {
+		enum MAP_SpanDir dir = i % 2;
+		enum MAP_Collision collision = i / 2 % 3;
+		u16 length = i % 23;
+
+		u16 expected = 0;
+		while (expected < length && MAP_getTile(&map,
+				xs[i] + (dir == MAP_SpanDir_RIGHT ? expected : 0),
+				ys[i] + (dir == MAP_SpanDir_DOWN ? expected : 0))->Collision != collision)
+			expected++;
+
+		wrong |= MAP_findCollision(&map, xs[i], ys[i], length, dir, collision) != expected;
+	}
+
+	printf("%-6s %8" PRIu64 " %8" PRIu64 " %8" PRIu64 "%s\n", bench_map->Name, times[0],
+			times[1], times[2], wrong ? "  WRONG" : "");
+
+	MAP_deInit(&map);
+	free(indices);
+
+	return wrong;
+}
+
+// Returns TRUE if the links of `objs` don't visit every object exactly once in sorted order,
+// or if the active objects don't match the list or are out of range.
+static bool checkObjList(const struct OBJ_Objects *objs)
+{
+	const SLL_List(OBJ_Object) *list = &objs->List;
+	const struct OBJ_Active *active = &objs->Active;
+	const struct SLL_Links *links = list->Base.Links;
+	u16 count = 0;
+	u16 left = SLL_NULL;
+
+	for (u16 node = list->Base.First; node != SLL_NULL; node = links[node].Right) {
+		if (node >= list->Base.Len || links[node].Left != left || count == list->Base.Len)
+			return TRUE;
+		if (left != SLL_NULL &&
+				OBJ_getColumn(&list->Items[left]) > OBJ_getColumn(&list->Items[node]))
+			return TRUE;
+
+		left = node;
+		count++;
+	}
+
+	// Each active object must be in range and sorted by the column it's in.
+	u16 num_active = 0;
+	for (u16 i = 0; i < list->Base.Len; i++) {
+		u16 slot = active->Slots[i];
+		if (slot == SLL_NULL)
+			continue;
+
+		MAP_Pos column = FXD_convert(OBJ_Pos, MAP_Pos, active->PosX[slot]);
+		if (slot >= active->Len || active->Indices[slot] != i ||
+				active->Columns[slot] != column || OBJ_getColumn(&list->Items[i]) != column ||
+				column < active->Left || column > active->Right)
+			return TRUE;
+		num_active++;
+	}
+
+	return count != list->Base.Len || list->Base.Last != left || num_active != active->Len;
+}
+
+// Number of objects and steps that `runCollisions` simulates
+#define NUM_FALLERS 256
+#define NUM_FALL_STEPS 64
+
+// Drops objects of every type all over the map, moving sideways and bouncing off walls, and
+// prints the time per thousand tile collisions with and without the collision grid, including
+// keeping the objects sorted. With the grid, the objects in the left half of the map start out
+// active and stop being active when they leave it, so every way of storing their positions is
+// used. Returns TRUE if the objects ever end up in different places or hit different things.
+static bool runCollisions(const struct BenchMap *bench_map, u16 rounds)
+{
+	struct MAP_Map map;
+	MAP_TileIndex *indices;
+	initBenchMap(&map, bench_map, &indices);
+	MAP_initGuard(&map);
+
+	static struct OBJ_Object starts[NUM_FALLERS];
+	struct OBJ_Objects objs[2];
+	COM_zero(&objs);
+	u32 hits[2] = {0};
+
+	u32 seed = 4242;
+	for (u16 i = 0; i < NUM_FALLERS; i++) {
+		struct OBJ_Object *obj = &starts[i];
+		COM_zero(obj);
+
+		seed = seed * 1103515245 + 12345;
+		obj->PosX = (OBJ_Pos)((seed >> 8) % ((u32)map.SizeX << OBJ_Pos_POINT));
+		seed = seed * 1103515245 + 12345;
+		obj->PosY = (OBJ_Pos)((seed >> 8) % ((u32)map.SizeY << OBJ_Pos_POINT));
+		seed = seed * 1103515245 + 12345;
+		obj->VelX = (OBJ_Vel)((seed >> 16) % 511) - 255;
+
+		obj->Type = i % OBJ_Type_LEN;
+		obj->FlipAcrossX = i / 3 % 2;
+		obj->FlipAcrossY = i / 6 % 2;
+	}
+
+	u64 times[2] = {0};
+	bool wrong = FALSE;
+
+	for (u16 pass = 0; pass < 2; pass++) {
+		if (pass == 1 && MAP_initCollisions(&map)) {
+			wrong = TRUE;
+			break;
+		}
+
+		for (u16 round = 0; round < rounds; round++) {
+			// Each object's index is the order it was added in.
+			OBJ_deInit(&objs[pass]);
+			OBJ_init(&objs[pass], NUM_FALLERS, NUM_FALLERS);
+			for (u16 i = 0; i < NUM_FALLERS; i++)
+				SLL_OBJ_Object_add(&objs[pass].List, &starts[i], SLL_NULL);
+			if (pass == 1)
+				OBJ_setActiveRange(&objs[pass], 0, map.SizeX / 2);
+			hits[pass] = 0;
+
+			u64 start = now();
+
+			for (u16 i = 0; i < NUM_FALLERS; i++) {
+				for (u16 step = 0; step < NUM_FALL_STEPS; step++) {
+					OBJ_addPosX(&objs[pass], i, *OBJ_velX(&objs[pass], i));
+					OBJ_addPosY(&objs[pass], i, *OBJ_velY(&objs[pass], i));
+
+					enum OBJ_Hit hit = OBJ_tileCollision(&objs[pass], i, &map);
+					hits[pass] = hits[pass] * 31 + hit;
+
+					// Fall, and turn around after hitting a wall.
+					OBJ_Vel *vel_y = OBJ_velY(&objs[pass], i);
+					*vel_y = COM_min(*vel_y + 24, 255);
+					if (hit & OBJ_Hit_HORIZ)
+						*OBJ_velX(&objs[pass], i) = hit & OBJ_Hit_LEFT ? 100 : -100;
+				}
+			}
+
+			times[pass] += now() - start;
+		}
+
+		times[pass] = times[pass] * 1000 / ((u64)rounds * NUM_FALLERS * NUM_FALL_STEPS);
+	}
+
+	// Both passes sort the objects the same way, so even their links must match.
+	wrong = wrong || hits[0] != hits[1] ||
+			memcmp(objs[0].List.Base.Links, objs[1].List.Base.Links,
+					NUM_FALLERS * sizeof(*objs[0].List.Base.Links)) != 0 ||
+			objs[0].List.Base.First != objs[1].List.Base.First ||
+			checkObjList(&objs[0]) || checkObjList(&objs[1]);
+	for (u16 i = 0; i < NUM_FALLERS && !wrong; i++) {
+		struct OBJ_Object obj[2];
+		OBJ_get(&objs[0], i, &obj[0]);
+		OBJ_get(&objs[1], i, &obj[1]);
+		wrong = memcmp(&obj[0], &obj[1], sizeof(obj[0])) != 0;
+	}
+	OBJ_deInit(&objs[0]);
+	OBJ_deInit(&objs[1]);
+
+	printf("%-6s %8" PRIu64 " %8" PRIu64 "%s\n", bench_map->Name, times[0], times[1],
+			wrong ? "  WRONG" : "");
+
+	MAP_deInit(&map);
+	free(indices);
+
+	return wrong;
+}
+
+// Sizes of the lists that `runSortedList` times
+const u16 LIST_SIZES[] = {1000, 10000};
+
+// Number of times each node is moved in `runSortedList`
+#define NUM_LIST_MOVES 4
+
+// Returns TRUE if the links of `list` don't visit every node exactly once in sorted order.
+static bool checkList(const SLL_List(MAP_Obj) *list)
+{
+	const struct SLL_Links *links = list->Base.Links;
+	u16 count = 0;
+	u16 left = SLL_NULL;
+
+	for (u16 node = list->Base.First; node != SLL_NULL; node = links[node].Right) {
+		if (node >= list->Base.Len || links[node].Left != left || count == list->Base.Len)
+			return TRUE;
+		if (left != SLL_NULL && (MAP_Pos)COM_be16(list->Items[left].PosX) >
+				(MAP_Pos)COM_be16(list->Items[node].PosX))
+			return TRUE;
+
+		left = node;
+		count++;
+	}
+
+	return count != list->Base.Len || list->Base.Last != left;
+}
+
+// Fills a list of `size` map objects spread out along a level like a map file, once walking
+// from the start and once from the last one added, then moves every object back and forth
+// by a few tiles and finally removes them in a random order. Prints the time each operation
+// takes on average. Returns TRUE if the lists ever end up broken or different.
+static bool runSortedList(u16 size, u16 rounds)
+{
+	// Only one list of ten thousand fits in the heap, so the links of the first are copied.
+	SLL_List(MAP_Obj) list_obj;
+	SLL_List(MAP_Obj) *list = &list_obj;
+	COM_zero(list);
+
+	MAP_Pos *keys = malloc(size * sizeof(*keys));
+	struct SLL_Links *links = malloc(size * sizeof(*links));
+	bool wrong = FALSE;
+	u64 times[4] = {0};
+
+	for (u16 round = 0; round < rounds; round++) {
+		u32 seed = 777 + round;
+		MAP_Pos key = 0;
+		for (u16 i = 0; i < size; i++) {
+			seed = seed * 1103515245 + 12345;
+			key = COM_max(key + (MAP_Pos)((seed >> 16) % 8) - 2, 0);
+			keys[i] = key;
+		}
+
+		for (u16 pass = 0; pass < 2; pass++) {
+			SLL_MAP_Obj_init(list, size);
+
+			u64 start = now();
+			u16 last = SLL_NULL;
+			for (u16 i = 0; i < size; i++) {
+				struct MAP_Obj obj = {.PosX = COM_be16(keys[i])};
+				last = SLL_MAP_Obj_add(list, &obj, pass == 0 ? SLL_NULL : last);
+			}
+			times[pass] += now() - start;
+
+			wrong |= last == SLL_NULL || checkList(list);
+
+			// Both ways of adding put equal keys in the same order, so the links must match.
+			if (pass == 0) {
+				memcpy(links, list->Base.Links, size * sizeof(*links));
+				SLL_MAP_Obj_deInit(list);
+			} else {
+				wrong |= memcmp(links, list->Base.Links, size * sizeof(*links)) != 0;
+			}
+		}
+
+		u64 start = now();
+		for (u16 move = 0; move < NUM_LIST_MOVES; move++) {
+			for (u16 i = 0; i < size; i++) {
+				struct MAP_Obj *obj = &list->Items[i];
+				seed = seed * 1103515245 + 12345;
+				key = COM_max((MAP_Pos)COM_be16(obj->PosX) + (MAP_Pos)((seed >> 16) % 9) - 4,
+						0);
+				obj->PosX = COM_be16(key);
+				SLL_MAP_Obj_sort(list, i);
+			}
+		}
+		times[2] += now() - start;
+		wrong |= checkList(list);
+
+		start = now();
+		while (list->Base.Len > 0) {
+			seed = seed * 1103515245 + 12345;
+			SLL_MAP_Obj_remove(list, (seed >> 16) % list->Base.Len);
+			if (list->Base.Len == size / 2) {
+				// Don't time checking the list halfway through.
+				u64 check_start = now();
+				wrong |= checkList(list);
+				start += now() - check_start;
+			}
+		}
+		times[3] += now() - start;
+		wrong |= list->Base.First != SLL_NULL || list->Base.Last != SLL_NULL;
+
+		SLL_MAP_Obj_deInit(list);
+	}
+
+	free(keys);
+	free(links);
+
+	printf("%-6u %8" PRIu64 " %8" PRIu64 " %8" PRIu64 " %8" PRIu64 "%s\n", size,
+			times[0] / ((u64)rounds * size), times[1] / ((u64)rounds * size),
+			times[2] / ((u64)rounds * size * NUM_LIST_MOVES), times[3] / ((u64)rounds * size),
+			wrong ? "  WRONG" : "");
+
+	return wrong;
+}
+
+// Numbers of active objects that `runIntegration` moves
+const u16 INTEGRATION_SIZES[] = {64, 1000};
+
+// Number of frames that `runIntegration` moves the objects for each round
+#define NUM_INTEGRATION_STEPS 16
+
+// Moves `size` objects by their velocities for a number of frames, one at a time with
+// `OBJ_addPosX/Y` and then all at once as active objects with `OBJ_moveActive`, and prints the
+// time per thousand objects moved for each. Returns TRUE if they don't end up in the same
+// places, or if the list ends up unsorted.
+static bool runIntegration(u16 size, u16 rounds)
+{
+	struct OBJ_Objects objs[2];
+	COM_zero(&objs);
+
+	// The objects are spread over a couple of screens and bounce between their edges.
+	static struct OBJ_Object starts[1000];
+	u32 seed = 99;
+	for (u16 i = 0; i < size; i++) {
+		struct OBJ_Object *obj = &starts[i];
+		COM_zero(obj);
+
+		seed = seed * 1103515245 + 12345;
+		obj->PosX = (OBJ_Pos)((seed >> 8) % (40 << OBJ_Pos_POINT));
+		seed = seed * 1103515245 + 12345;
+		obj->PosY = (OBJ_Pos)((seed >> 8) % (20 << OBJ_Pos_POINT));
+		seed = seed * 1103515245 + 12345;
+		obj->VelX = (OBJ_Vel)((seed >> 16) % 129) - 64;
+		obj->VelY = (OBJ_Vel)((seed >> 24) % 65) - 32;
+	}
+
+	u64 times[2] = {0};
+	bool wrong = FALSE;
+
+	for (u16 round = 0; round < rounds; round++) {
+		for (u16 pass = 0; pass < 2; pass++) {
+			struct OBJ_Objects *pass_objs = &objs[pass];
+
+			OBJ_init(pass_objs, size, size);
+			u16 last = SLL_NULL;
+			for (u16 i = 0; i < size; i++)
+				last = SLL_OBJ_Object_add(&pass_objs->List, &starts[i], last);
+			// In the game, objects only become active when the camera moves to another
+			// column, so that isn't timed.
+			if (pass == 1)
+				OBJ_setActiveRange(pass_objs, -2, 42);
+
+			for (u16 step = 0; step < NUM_INTEGRATION_STEPS; step++) {
+				u64 start = now();
+				if (pass == 0) {
+					for (u16 i = 0; i < size; i++) {
+						OBJ_addPosX(pass_objs, i, pass_objs->List.Items[i].VelX);
+						OBJ_addPosY(pass_objs, i, pass_objs->List.Items[i].VelY);
+					}
+				} else {
+					OBJ_moveActive(pass_objs);
+				}
+				times[pass] += now() - start;
+
+				// Turn around at the edges, which isn't timed since it isn't part of moving.
+				for (u16 i = 0; i < size; i++) {
+					OBJ_Pos pos_x = OBJ_getPosX(pass_objs, i);
+					OBJ_Vel *vel_x = OBJ_velX(pass_objs, i);
+					if ((pos_x < 0 && *vel_x < 0) ||
+							(pos_x > (40 << OBJ_Pos_POINT) && *vel_x > 0))
+						*vel_x = -*vel_x;
+				}
+			}
+
+			wrong |= checkObjList(pass_objs);
+		}
+
+		// Every object must still be active, and in the same place either way.
+		wrong |= objs[1].Active.Len != size;
+		for (u16 i = 0; i < size; i++) {
+			struct OBJ_Object obj[2];
+			OBJ_get(&objs[0], i, &obj[0]);
+			OBJ_get(&objs[1], i, &obj[1]);
+			wrong |= memcmp(&obj[0], &obj[1], sizeof(obj[0])) != 0;
+		}
+
+		OBJ_deInit(&objs[0]);
+		OBJ_deInit(&objs[1]);
+	}
+
+	u64 moved = (u64)rounds * NUM_INTEGRATION_STEPS * size;
+	printf("%-6u %8" PRIu64 " %8" PRIu64 "%s\n", size, times[0] * 1000 / moved,
+			times[1] * 1000 / moved, wrong ? "  WRONG" : "");
+
+	return wrong;
+}
+
+// Keys held down by the scripted player in `runReplay`, each for a number of frames
+const struct ScriptStep
+{
+	u32 Keys;
+	u16 Frames;
+} SCRIPT[] = {
+	{0, 10},
+	{1 << RR_RIGHT, 40},
+	{1 << RR_RIGHT | 1 << RR_DIAMOND, 25},
+	{1 << RR_DOWN, 7},
+	{1 << RR_LEFT | 1 << RR_UP, 30},
+	{1 << RR_LEFT | 1 << RR_UP | 1 << RR_DIAMOND, 3},
+	{0, 1},
+	{1 << RR_BCKSPC, 2},
+	{1 << RR_DOWN | 1 << RR_RIGHT | 1 << RR_DIAMOND, 50},
+};
+
+// Number of powers of two of nanoseconds in the histogram of `runReplay`
+#define HISTOGRAM_LEN 40
+
+// Plays the level for `frames` frames with scripted keys, recording them, and then replays the
+// saved recording headlessly as fast as possible. Prints the total and average time of the
+// replay and a histogram of its frame times. Returns TRUE if live play recorded anything or
+// replayed the file left behind, the replay didn't see the same keys on every frame, or memory
+// leaked.
+static bool runReplay(u16 frames)
+{
+	HostCalculator = TI89;
+
+	u32 initial_mem = HeapAvail();
+	u16 *expected = malloc((frames + 1) * sizeof(*expected));
+
+	struct GME_Game game;
+	COM_zero(&game);
+
+	FILES file;
+	bool wrong = FALSE;
+
+#if !defined(REPLAY) && !defined(RECORD)
+	// Live play neither records nor saves anything.
+	GME_init(&game);
+	wrong |= game.Level.Input.Mode != INP_Mode_LIVE || game.Level.Input.Runs != NULL;
+	HostKeys = 1 << RR_ESC;
+	GME_loop(&game);
+	GME_deInit(&game);
+	wrong |= FOpen("sgl\\lastrun", &file, FM_READ, "sgli") == FS_OK;
+#endif
+
+	// Record. Levels are only recorded when RECORD is defined, so the bench starts recording
+	// itself. Ending the level saves the recording either way.
+	GME_init(&game);
+	INP_deInit(&game.Level.Input);
+	INP_initRecord(&game.Level.Input, GME_LVL_RECORD_RUNS);
+
+	u16 step = 0;
+	u16 step_frame = 0;
+	for (u16 frame = 0; frame < frames; frame++) {
+		HostKeys = SCRIPT[step].Keys;
+		if (++step_frame == SCRIPT[step].Frames) {
+			step = (step + 1) % (sizeof(SCRIPT) / sizeof(*SCRIPT));
+			step_frame = 0;
+		}
+
+		GME_loop(&game);
+		expected[frame] = game.Level.Input.Keys;
+	}
+
+	// Escape ends the level, which saves the recording.
+	HostKeys = 1 << RR_ESC;
+	GME_loop(&game);
+	expected[frames] = 1 << INP_Key_ESC;
+	GME_deInit(&game);
+
+	// The recording becomes the replay. Variables end with a zero, their type, a zero, and a
+	// tag, which aren't part of the data.
+	bool saved = FOpen("sgl\\lastrun", &file, FM_READ, "sgli") == FS_OK;
+	wrong |= !saved;
+	if (saved) {
+		const u8 *data = HeapDeref(file.dataH);
+		HostAddFile("sgl\\replay", "sgli", data + 2, ((data[0] << 8) | data[1]) - 7);
+		FClose(&file);
+	}
+
+	// Replay. Like recording, the bench starts replaying itself. The keyboard is ignored, which
+	// holding down every key checks.
+	HostKeys = 0xFFFFFFFF;
+	GME_init(&game);
+	INP_deInit(&game.Level.Input);
+	wrong |= INP_initReplay(&game.Level.Input, GME_LVL_REPLAY_FILE);
+	wrong |= game.Level.Input.Mode != INP_Mode_REPLAY;
+
+	u32 histogram[HISTOGRAM_LEN] = {0};
+	u64 total = 0;
+	u32 played = 0;
+	while (game.State != GME_State_NONE) {
+		u64 start = now();
+		GME_loop(&game);
+		u64 time = now() - start;
+
+		total += time;
+		u16 bucket = 0;
+		while (bucket < HISTOGRAM_LEN - 1 && time >> (bucket + 1) != 0)
+			bucket++;
+		histogram[bucket]++;
+
+		// Ending the level zeroes the input, so the last frame is known to be escape.
+		u16 keys = game.State != GME_State_NONE ? game.Level.Input.Keys : 1 << INP_Key_ESC;
+		if (played > frames || keys != expected[played])
+			wrong = TRUE;
+		played++;
+	}
+	wrong |= played != (u32)frames + 1;
+
+	GME_deInit(&game);
+	HostKeys = 0;
+
+#ifndef REPLAY
+	// Levels only replay when REPLAY is defined, so the replay file left behind is ignored.
+	GME_init(&game);
+	wrong |= game.Level.Input.Mode == INP_Mode_REPLAY;
+	GME_deInit(&game);
+#endif
+	free(expected);
+
+	bool leaked = HeapAvail() != initial_mem;
+
+	printf("%-6" PRIu32 " %10" PRIu64 " %8" PRIu64 "%s%s\n", played, total,
+			total / COM_max(played, (u32)1), wrong ? "  WRONG" : "", leaked ? "  LEAK" : "");
+	for (u16 i = 0; i < HISTOGRAM_LEN; i++) {
+		if (histogram[i] != 0)
+			printf("  %10" PRIu64 " - %10" PRIu64 " %8" PRIu32 "\n", (u64)1 << i,
+					((u64)2 << i) - 1, histogram[i]);
+	}
+
+	return wrong || leaked;
+}
+
+void HOST_main(u16 argc, char **argv)
+{
+	u16 frames = 2000;
+	const char *filter = NULL;
+
+	for (u16 i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+			frames = atoi(argv[++i]);
+		else
+			filter = argv[i];
+	}
+
+	addBankFile("sgl\\tiles", &TEMP_TILE_BANK);
+	initBenchObjBank();
+	addBankFile("sgl\\objects", &BenchObjBank);
+	addMapFile("sgl\\level");
+
+	bool failed = checkMapFile("sgl\\level");
+	failed |= checkStorage();
+	failed |= checkFixedPoint(filter != NULL && strcmp(filter, "fxd") == 0);
+
+	// `GME_LVL_drawObjects` skips objects `OBJ_MAX_WIDTH` left of the screen, so it must be
+	// at least as wide as every object.
+	bool too_wide = FALSE;
+	for (u16 i = 0; i < OBJ_Type_LEN; i++)
+		too_wide |= (OBJECT_DEFS[i].ExtraWidth + 1) * SCR_SPRITE_SIZE > OBJ_MAX_WIDTH;
+	printf("Object widths: %s\n\n", too_wide ? "WRONG" : "within OBJ_MAX_WIDTH");
+	failed |= too_wide;
+
+	printf("%-6s %-9s %-5s %-5s", "map", "pattern", "calc", "width");
+	for (u16 phase = 0; phase < Phase_LEN; phase++)
+		printf(" %8s", PHASE_NAMES[phase]);
+	printf(" %8s %8s %8s\n", "frame", "min", "max");
+
+	for (u16 m = 0; m < sizeof(BENCH_MAPS) / sizeof(*BENCH_MAPS); m++) {
+		for (u16 p = 0; p < sizeof(PATTERNS) / sizeof(*PATTERNS); p++) {
+			char name[64];
+			snprintf(name, sizeof(name), "%s/%s", BENCH_MAPS[m].Name, PATTERNS[p].Name);
+			if (filter != NULL && strstr(name, filter) == NULL)
+				continue;
+
+			for (u16 c = 0; c < sizeof(CALCS) / sizeof(*CALCS); c++) {
+				for (u16 w = 0; w < SCR_BlitWidth_LEN; w++)
+					failed |= runScenario(&BENCH_MAPS[m], &PATTERNS[p], CALCS[c], w, frames);
+			}
+		}
+	}
+
+	printf("\nTile lookups near the map, time per thousand:\n");
+	printf("%-6s %8s %8s %8s\n", "map", "plain", "guarded", "grid");
+	for (u16 m = 0; m < sizeof(BENCH_MAPS) / sizeof(*BENCH_MAPS); m++) {
+		char name[64];
+		snprintf(name, sizeof(name), "%s/lookup", BENCH_MAPS[m].Name);
+		if ((filter != NULL && strstr(name, filter) == NULL) || BENCH_MAPS[m].Wrap)
+			continue;
+
+		failed |= runLookups(&BENCH_MAPS[m], COM_max(frames / 20, 1));
+	}
+
+	printf("\nTile collision of falling objects, time per thousand:\n");
+	printf("%-6s %8s %8s\n", "map", "tiles", "grid");
+	for (u16 m = 0; m < sizeof(BENCH_MAPS) / sizeof(*BENCH_MAPS); m++) {
+		char name[64];
+		snprintf(name, sizeof(name), "%s/collide", BENCH_MAPS[m].Name);
+		if ((filter != NULL && strstr(name, filter) == NULL) || BENCH_MAPS[m].Wrap)
+			continue;
+
+		failed |= runCollisions(&BENCH_MAPS[m], COM_max(frames / 100, 1));
+	}
+
+	printf("\nSorted list operations, time per operation:\n");
+	printf("%-6s %8s %8s %8s %8s\n", "size", "add", "hinted", "sort", "remove");
+	for (u16 i = 0; i < sizeof(LIST_SIZES) / sizeof(*LIST_SIZES); i++) {
+		char name[64];
+		snprintf(name, sizeof(name), "%u/list", LIST_SIZES[i]);
+		if (filter != NULL && strstr(name, filter) == NULL)
+			continue;
+
+		failed |= runSortedList(LIST_SIZES[i], COM_max(frames / 100, 1));
+	}
+
+	printf("\nObject movement, time per thousand objects:\n");
+	printf("%-6s %8s %8s\n", "size", "move", "active");
+	for (u16 i = 0; i < sizeof(INTEGRATION_SIZES) / sizeof(*INTEGRATION_SIZES); i++) {
+		char name[64];
+		snprintf(name, sizeof(name), "%u/move", INTEGRATION_SIZES[i]);
+		if (filter != NULL && strstr(name, filter) == NULL)
+			continue;
+
+		failed |= runIntegration(INTEGRATION_SIZES[i], COM_max(frames / 100, 1));
+	}
+
+	// This is last since the replay file it leaves behind would be replayed by every level in
+	// builds with REPLAY defined.
+	if (filter == NULL || strstr("replay", filter) != NULL) {
+		printf("\nHeadless replay of recorded keys, frame times:\n");
+		printf("%-6s %10s %8s\n", "frames", "total", "frame");
+		failed |= runReplay(frames);
+	}
+
+	printf("\nAverage blit time per calculator:\n");
+	for (u16 c = 0; c < sizeof(CALCS) / sizeof(*CALCS); c++) {
+		s16 calc = CALCS[c];
+		if (BlitCounts[calc][0] == 0)
+			continue;
+
+		u16 best = 0;
+		printf("%-5s", CALC_NAMES[calc]);
+		for (u16 w = 0; w < SCR_BlitWidth_LEN; w++) {
+			u64 average = BlitSums[calc][w] / BlitCounts[calc][w];
+			if (average < BlitSums[calc][best] / BlitCounts[calc][best])
+				best = w;
+
+			printf("  %s-bit %8" PRIu64, WIDTH_NAMES[w], average);
+		}
+		printf("  fastest: %s-bit\n", WIDTH_NAMES[best]);
+	}
+
+	if (failed) {
+		printf("Some scenarios failed.\n");
+		exit(1);
+	}
+}
@@ -0,0 +1,360 @@
+// Super Grayland: Copyright 2021 Vincent Robinson under the zlib license.
+// See `license.txt` for more information.
+// Before delving into the code, please read `readme_source.txt` to understand the basic design.
+
+// Implementation of the host tigcclib shim. See `tigcclib.h` for details. This file does not
+// include `common.h`, but follows the same rules apart from naming, which follows tigcclib.
+
+#include "tigcclib.h"
+
+#include <time.h>
+
+int16_t HostCalculator = TI89;
+uint32_t HostKeys = 0;
+ERROR_FRAME *HostErrorFrame = NULL;
+
+// Gray planes. Index 0 is the pair that `GrayOn` allocates and index 1 is the pair in the
+// buffer passed to `GrayDBufInit`, just like tigcclib.
+static uint8_t InternalPlanes[2][LCD_SIZE];
+static uint8_t *Planes[2][2] = {{InternalPlanes[LIGHT_PLANE], InternalPlanes[DARK_PLANE]}};
+static int16_t ActiveIdx = 0;
+// The plane that AMS drawing functions like `ClrScr` draw to.
+static uint8_t *AMSPlane = InternalPlanes[DARK_PLANE];
+
+// Memory
+#define HEAP_SIZE 188000
+
+static uint32_t HeapUsed = 0;
+
+// Allocations are prefixed with their size so `HeapAvail` can stay exact.
+union HeapHeader
+{
+	uint32_t Size;
+	uint64_t Align;
+};
+
+// Variables made with `HostAddFile` or written with `FWrite`. Their handles are their index
+// plus one.
+#define MAX_FILES 16
+
+static struct
+{
+	char Name[18];
+	char Type[5];
+	uint8_t *Memory;
+} Files[MAX_FILES];
+static uint16_t NumFiles = 0;
+
+int16_t GrayOn(void)
+{
+	return 1;
+}
+
+void GrayOff(void)
+{
+}
+
+void GrayDBufInit(void *buf)
+{
+	// The planes are aligned to eight bytes, which is why the buffer has eight extra bytes.
+	uint8_t *aligned = (uint8_t *)(((uintptr_t)buf + 7) & ~(uintptr_t)7);
+
+	Planes[1][LIGHT_PLANE] = aligned;
+	Planes[1][DARK_PLANE] = aligned + LCD_SIZE;
+	memset(aligned, 0, LCD_SIZE * 2);
+}
+
+void *GrayDBufGetActivePlane(int16_t plane)
+{
+	return Planes[ActiveIdx][plane];
+}
+
+void *GrayDBufGetHiddenPlane(int16_t plane)
+{
+	return Planes[!ActiveIdx][plane];
+}
+
+int16_t GrayDBufGetActiveIdx(void)
+{
+	return ActiveIdx;
+}
+
+int16_t GrayDBufGetHiddenIdx(void)
+{
+	return !ActiveIdx;
+}
+
+void GrayDBufSetHiddenAMSPlane(int16_t plane)
+{
+	AMSPlane = GrayDBufGetHiddenPlane(plane);
+}
+
+void GrayDBufToggleSync(void)
+{
+	ActiveIdx = !ActiveIdx;
+}
+
+int16_t FontSetSys(int16_t font)
+{
+	(void)font;
+	return F_6x8;
+}
+
+void ClrScr(void)
+{
+	memset(AMSPlane, 0, LCD_SIZE);
+}
+
+void DrawStr(int16_t x, int16_t y, const char *str, int16_t attr)
+{
+	(void)x;
+	(void)y;
+	(void)str;
+	(void)attr;
+}
+
+// Set or clear a single pixel of a plane if it is on the screen.
+static void setPixel(uint8_t *plane, int16_t x, int16_t y, uint8_t on)
+{
+	if (x < 0 || x >= LCD_WIDTH || y < 0 || y >= LCD_HEIGHT)
+		return;
+
+	uint8_t *byte = plane + y * LCD_LINE_BYTES + x / 8;
+	uint8_t bit = 0x80 >> (x % 8);
+
+	if (on)
+		*byte |= bit;
+	else
+		*byte &= ~bit;
+}
+
+void ScrRectFill(const SCR_RECT *rect, const SCR_RECT *clip, int16_t attr)
+{
+	int16_t x0 = rect->xy.x0 > clip->xy.x0 ? rect->xy.x0 : clip->xy.x0;
+	int16_t y0 = rect->xy.y0 > clip->xy.y0 ? rect->xy.y0 : clip->xy.y0;
+	int16_t x1 = rect->xy.x1 < clip->xy.x1 ? rect->xy.x1 : clip->xy.x1;
+	int16_t y1 = rect->xy.y1 < clip->xy.y1 ? rect->xy.y1 : clip->xy.y1;
+
+	for (int16_t y = y0; y <= y1; y++) {
+		for (int16_t x = x0; x <= x1; x++) {
+			if (attr == A_XOR) {
+				uint8_t *byte = AMSPlane + y * LCD_LINE_BYTES + x / 8;
+				setPixel(AMSPlane, x, y, !(*byte & (0x80 >> (x % 8))));
+			} else {
+				setPixel(AMSPlane, x, y, attr == A_NORMAL);
+			}
+		}
+	}
+}
+
+// Draw one row of a sprite with the pixels in `bits`, where the leftmost pixel is the most
+// significant of the `width` bits.
+static void spriteRow(uint8_t *plane, int16_t x, int16_t y, uint32_t bits, int16_t width,
+		int16_t mode)
+{
+	for (int16_t i = 0; i < width; i++) {
+		int16_t px = x + i;
+		if (px < 0 || px >= LCD_WIDTH || y < 0 || y >= LCD_HEIGHT)
+			continue;
+
+		uint8_t set = (bits >> (width - 1 - i)) & 1;
+		uint8_t old = (plane[y * LCD_LINE_BYTES + px / 8] >> (7 - px % 8)) & 1;
+
+		switch (mode) {
+		case SPRT_XOR:
+			setPixel(plane, px, y, old ^ set);
+			break;
+		case SPRT_OR:
+			setPixel(plane, px, y, old | set);
+			break;
+		case SPRT_AND:
+			setPixel(plane, px, y, old & set);
+			break;
+		default:
+			setPixel(plane, px, y, set);
+			break;
+		}
+	}
+}
+
+void Sprite16(int16_t x, int16_t y, int16_t height, const uint16_t *sprite, void *plane,
+		int16_t mode)
+{
+	for (int16_t row = 0; row < height; row++)
+		spriteRow(plane, x, y + row, sprite[row], 16, mode);
+}
+
+void ClipSprite8(int16_t x, int16_t y, int16_t height, const uint8_t *sprite, void *plane,
+		int16_t mode)
+{
+	for (int16_t row = 0; row < height; row++)
+		spriteRow(plane, x, y + row, sprite[row], 8, mode);
+}
+
+void *HeapAllocPtr(uint32_t size)
+{
+	if (HeapUsed + size > HEAP_SIZE)
+		return NULL;
+
+	union HeapHeader *header = malloc(sizeof(union HeapHeader) + size);
+	if (header == NULL)
+		return NULL;
+
+	header->Size = size;
+	HeapUsed += size;
+
+	return header + 1;
+}
+
+void HeapFreePtr(void *ptr)
+{
+	union HeapHeader *header = (union HeapHeader *)ptr - 1;
+
+	HeapUsed -= header->Size;
+	free(header);
+}
+
+uint32_t HeapAvail(void)
+{
+	return HEAP_SIZE - HeapUsed;
+}
+
+void *HeapDeref(HANDLE handle)
+{
+	return Files[handle - 1].Memory;
+}
+
+// Finds the variable called `name`, returning its index or NumFiles if there is none.
+static uint16_t findFile(const char *name)
+{
+	uint16_t i = 0;
+	while (i < NumFiles && strcmp(Files[i].Name, name) != 0)
+		i++;
+	return i;
+}
+
+// Gets the size of the data of a variable, not counting its size or type.
+static uint16_t fileDataSize(uint16_t i)
+{
+	uint16_t var_size = (Files[i].Memory[0] << 8) | Files[i].Memory[1];
+	return var_size - strlen(Files[i].Type) - 3;
+}
+
+uint16_t FOpen(const char *name, FILES *file, int16_t mode, const char *type)
+{
+	// Writing replaces the variable with an empty one.
+	if (mode == FM_WRITE)
+		HostAddFile(name, type, NULL, 0);
+	else if (mode != FM_READ)
+		return FS_ERROR;
+
+	uint16_t i = findFile(name);
+	if (i == NumFiles)
+		return FS_NOT_FOUND;
+	if (strcmp(Files[i].Type, type) != 0)
+		return FS_ERROR;
+
+	file->dataH = i + 1;
+	file->fileMode = mode;
+	return FS_OK;
+}
+
+uint16_t FWrite(const void *buffer, uint16_t size, FILES *file)
+{
+	if (file->fileMode != FM_WRITE)
+		return FS_ERROR;
+
+	uint16_t i = file->dataH - 1;
+	uint16_t old_size = fileDataSize(i);
+
+	uint8_t *data = malloc(old_size + size);
+	memcpy(data, Files[i].Memory + 2, old_size);
+	memcpy(data + old_size, buffer, size);
+
+	HostAddFile(Files[i].Name, Files[i].Type, data, old_size + size);
+	free(data);
+
+	return FS_OK;
+}
+
+uint16_t FClose(FILES *file)
+{
+	file->fileMode = FM_CLOSED;
+	return FS_OK;
+}
+
+void HostAddFile(const char *name, const char *type, const void *data, uint16_t size)
+{
+	// An existing variable with the same name is replaced.
+	uint16_t i = findFile(name);
+	if (i == NumFiles) {
+		if (NumFiles == MAX_FILES) {
+			fprintf(stderr, "Too many host files\n");
+			exit(1);
+		}
+		NumFiles++;
+	} else {
+		free(Files[i].Memory);
+	}
+
+	// Custom type variables end with a zero, the type, another zero, and OTH_TAG, which are
+	// all included in the size.
+	uint16_t type_len = strlen(type);
+	uint16_t var_size = size + type_len + 3;
+
+	uint8_t *memory = malloc(2 + var_size);
+	memory[0] = var_size >> 8;
+	memory[1] = var_size & 0xFF;
+	if (size != 0)
+		memcpy(memory + 2, data, size);
+	memory[2 + size] = 0;
+	memcpy(memory + 3 + size, type, type_len);
+	memory[3 + size + type_len] = 0;
+	memory[4 + size + type_len] = 0xF8;
+
+	// The name and type may be those of the variable being replaced.
+	if (Files[i].Name != name)
+		snprintf(Files[i].Name, sizeof(Files[i].Name), "%s", name);
+	if (Files[i].Type != type)
+		snprintf(Files[i].Type, sizeof(Files[i].Type), "%s", type);
+	Files[i].Memory = memory;
+}
+
+void ER_throw(uint16_t code)
+{
+	ERROR_FRAME *frame = HostErrorFrame;
+	if (frame == NULL) {
+		fprintf(stderr, "Uncaught error %u\n", code);
+		exit(1);
+	}
+
+	HostErrorFrame = frame->Prev;
+	longjmp(frame->Buf, code);
+}
+
+void ER_success(void)
+{
+	HostErrorFrame = HostErrorFrame->Prev;
+}
+
+void GKeyFlush(void)
+{
+}
+
+int16_t ngetchx(void)
+{
+	return 0;
+}
+
+uint32_t HostClock(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint32_t)time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+int main(int argc, char **argv)
+{
+	HOST_main(argc, argv);
+	return 0;
+}
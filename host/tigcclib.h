@@ -0,0 +1,175 @@
+// Super Grayland: Copyright 2021 Vincent Robinson under the zlib license.
+// See `license.txt` for more information.
+// Before delving into the code, please read `readme_source.txt` to understand the basic design.
+
+#pragma once
+
+// Host tigcclib shim
+/*
+	This header stands in for GCC4TI's `tigcclib.h` so that the calculator source in `src` can
+	be compiled and run on a normal computer for benchmarking and regression checking. It is
+	only found by the compiler when building with `comp host` (see `comp.bat` and `comp.sh`),
+	which puts this directory on the include path.
+
+	Only the parts of tigcclib that SGL actually uses are provided, and they are emulated
+	closely enough for drawing to produce the same pixels as on the calculator: the gray planes
+	are real 240x128 buffers, sprites and rectangles are really drawn, and errors really unwind
+	to the nearest TRY block. Things with no meaning on a computer, like fonts and text drawing,
+	do nothing.
+
+	Some things that are macros in tigcclib are variables here so that the host can change
+	them: `CALCULATOR` can be set through `HostCalculator` to emulate the large screens, and
+	`_keytest` reads the `HostKeys` bitmask. Likewise, there is no VAT, so the host program
+	creates the variables that SGL opens with `HostAddFile`.
+
+	`common.h` poisons `int` and friends right after including this header, so nothing here may
+	be a macro that needs those words to be written by the code that uses it. The C entry point
+	also lives in `tigcclib.c` for the same reason; it calls `HOST_main`, which the host program
+	must define in place of `_main`.
+*/
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Calculator models
+#define TI89     0
+#define TI92PLUS 1
+#define V200     3
+
+// The emulated calculator model; one of the constants above. It is TI89 by default.
+extern int16_t HostCalculator;
+#define CALCULATOR HostCalculator
+
+// Screen dimensions
+#define LCD_WIDTH  240
+#define LCD_HEIGHT 128
+#define LCD_LINE_BYTES (LCD_WIDTH / 8)
+#define LCD_SIZE (LCD_LINE_BYTES * LCD_HEIGHT)
+
+// Grayscale
+#define LIGHT_PLANE 0
+#define DARK_PLANE  1
+
+#define GRAYDBUFFER_SIZE (LCD_SIZE * 2 + 8)
+
+int16_t GrayOn(void);
+void GrayOff(void);
+void GrayDBufInit(void *buf);
+void *GrayDBufGetActivePlane(int16_t plane);
+void *GrayDBufGetHiddenPlane(int16_t plane);
+int16_t GrayDBufGetActiveIdx(void);
+int16_t GrayDBufGetHiddenIdx(void);
+void GrayDBufSetHiddenAMSPlane(int16_t plane);
+void GrayDBufToggleSync(void);
+
+// Drawing
+enum Attrs {A_REVERSE, A_NORMAL, A_XOR};
+enum SprtModes {SPRT_XOR, SPRT_OR, SPRT_AND, SPRT_RPLC};
+enum Fonts {F_4x6, F_6x8, F_8x10};
+
+typedef union
+{
+	struct {
+		uint8_t x0, y0, x1, y1;
+	} xy;
+	uint32_t l;
+} SCR_RECT;
+
+int16_t FontSetSys(int16_t font);
+void ClrScr(void);
+void DrawStr(int16_t x, int16_t y, const char *str, int16_t attr);
+void ScrRectFill(const SCR_RECT *rect, const SCR_RECT *clip, int16_t attr);
+void Sprite16(int16_t x, int16_t y, int16_t height, const uint16_t *sprite, void *plane,
+		int16_t mode);
+void ClipSprite8(int16_t x, int16_t y, int16_t height, const uint8_t *sprite, void *plane,
+		int16_t mode);
+
+// Heap. The host pretends to have as much free memory as an empty TI-89 Titanium.
+typedef uint16_t HANDLE;
+#define H_NULL 0
+
+void *HeapAllocPtr(uint32_t size);
+void HeapFreePtr(void *ptr);
+uint32_t HeapAvail(void);
+
+void *HeapDeref(HANDLE handle);
+
+// Files. Only the handle of an open file is of any use to SGL, which reads files in place and
+// only ever writes them from start to end.
+typedef struct
+{
+	HANDLE dataH;
+	uint16_t fileMode;
+} FILES;
+
+enum FileModes {FM_CLOSED, FM_READ, FM_WRITE, FM_APPEND};
+enum FileStatus {FS_OK = 0, FS_ERROR = 0xFFFE, FS_NOT_FOUND = 0xFFFB};
+
+// Only reading and writing are supported. Reading fails if the file doesn't exist or has a
+// different type, and writing replaces the file with an empty one. Like on the calculator,
+// writing moves the file's memory, so nothing may be reading it in place at the same time.
+uint16_t FOpen(const char *name, FILES *file, int16_t mode, const char *type);
+uint16_t FWrite(const void *buffer, uint16_t size, FILES *file);
+uint16_t FClose(FILES *file);
+
+// Creates a variable named `name` with a custom type of `type`, holding a copy of `size` bytes
+// of `data`, replacing any variable with the same name. Like on the calculator, the memory
+// `HeapDeref` returns for it starts with its big endian size and ends with its type tag.
+void HostAddFile(const char *name, const char *type, const void *data, uint16_t size);
+
+// Errors
+typedef struct ErrorFrame
+{
+	jmp_buf Buf;
+	struct ErrorFrame *Prev;
+} ERROR_FRAME;
+
+extern ERROR_FRAME *HostErrorFrame;
+
+void ER_throw(uint16_t code) __attribute__((noreturn));
+void ER_success(void);
+
+#define TRY															\
+	{																\
+		ERROR_FRAME _er_frame;										\
+		_er_frame.Prev = HostErrorFrame;							\
+		HostErrorFrame = &_er_frame;								\
+		volatile uint16_t errCode = setjmp(_er_frame.Buf);			\
+		if (errCode == 0) {
+#define ONERR														\
+			ER_success();											\
+		} else {
+#define ENDTRY														\
+		}															\
+	}
+
+// Keyboard. These are single key numbers instead of tigcclib's row/column pairs since
+// `_keytest` only ever gets them passed straight through.
+enum HostKey
+{
+	RR_UP, RR_LEFT, RR_DOWN, RR_RIGHT,
+	RR_2ND, RR_SHIFT, RR_DIAMOND, RR_ALPHA,
+	RR_ESC, RR_BCKSPC, RR_ENTER,
+	HostKey_LEN
+};
+
+// Bitmask of currently pressed keys, where `1 << key` is set for each pressed `HostKey`.
+extern uint32_t HostKeys;
+
+#define _keytest(key) ((HostKeys & ((uint32_t)1 << (key))) != 0)
+
+void GKeyFlush(void);
+int16_t ngetchx(void);
+
+// Profiling. There is no programmable rate generator to time with here, so the profiler reads
+// this clock instead, which ticks every nanosecond and wraps around. `HOST_CLOCK` marks that
+// it exists.
+#define HOST_CLOCK
+uint32_t HostClock(void);
+
+// The host program's entry point, used instead of `_main`.
+void HOST_main(uint16_t argc, char **argv);
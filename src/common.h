@@ -114,13 +114,154 @@ register s32 Debug asm("d7");
 // Round a fixed point number up
 #define FXD_ceil(type, num) ((((num) - 1) + FXD_denom(type)) & ~FXD_denomMask(type))
 
-// TODO: Test mult and div. Do they work with signed numbers?
-// Muliply two fixed point numbers. The most significant `<type>_POINT` bytes will be truncated.
-#define FXD_mult(type, num1, num2) (((num1) * (num2)) >> type##_POINT)
-// Divide one fixed point number by another. The most significant `<type>_POINT` bytes will be
-// truncated.
-#define FXD_div(type, num1, num2) \
-		((((num1) << type##_POINT) / ((num2) << type##_POINT)) >> type##_POINT)
+// Multiplication and division:
+/*
+	`FXD_mult` and `FXD_div` multiply or divide two numbers of the same fixed point type, which
+	may be stored in integers of different sizes, like `OBJ_Pos` and `OBJ_Vel`. Both return an
+	s32 with the same point. Products are floored like `>>`, and quotients are truncated
+	towards zero like `/`. Anything that doesn't fit in 32 bits is truncated from the top.
+
+	The 68000 can only multiply 16 bit numbers into a 32 bit result (`muls` and `mulu`) and
+	divide a 32 bit number by a 16 bit one (`divs` and `divu`). Anything bigger is done by a
+	libgcc function that takes hundreds of cycles, and multiplying 32 bit numbers just to shift
+	the result would even need 64 bits. So, these macros pick a kernel based on the sizes of
+	the operands, and each kernel only uses multiplications of 16 bit halves:
+	* 16 by 16 bits is a single `muls`.
+	* 32 by 16 bits is two, for the high and low halves of the 32 bit number.
+	* 32 by 32 bits is four, like long multiplication with 16 bit digits, but the product of
+	  the high halves only matters for the lowest bits of the top half of the result.
+	Division divides the integer parts first and then finds the fractional bits one at a time,
+	which is only a shift and a comparison each since the remainder is smaller than the divisor.
+	Whenever the divisor's magnitude fits in 16 bits, even if it's stored in 32, the integer
+	division is a single `divu`, or two if the quotient doesn't fit in 16 bits, like long
+	division with 16 bit digits. Only bigger divisors still need libgcc.
+
+	These only work for types with a point of 16 or less. `host/bench.c` checks them against
+	64 bit arithmetic.
+*/
+
+// Multiplies two fixed point numbers of type `type`.
+#define FXD_mult(type, num1, num2)											\
+({																			\
+	typeof(num1) _num1 = (num1);											\
+	typeof(num2) _num2 = (num2);											\
+	sizeof(_num1) <= 2 && sizeof(_num2) <= 2 ?								\
+			FXD_mult16(type##_POINT, _num1, _num2) :						\
+	sizeof(_num2) <= 2 ? FXD_mult32x16(type##_POINT, _num1, _num2) :		\
+	sizeof(_num1) <= 2 ? FXD_mult32x16(type##_POINT, _num2, _num1) :		\
+			FXD_mult32(type##_POINT, _num1, _num2);							\
+})
+// Divides one fixed point number of type `type` by another.
+#define FXD_div(type, num1, num2)											\
+({																			\
+	typeof(num1) _num1 = (num1);											\
+	typeof(num2) _num2 = (num2);											\
+	sizeof(_num1) <= 2 && sizeof(_num2) <= 2 ?								\
+			FXD_div16(type##_POINT, _num1, _num2) :							\
+			FXD_div32(type##_POINT, _num1, _num2);							\
+})
+
+// The kernels for `FXD_mult` and `FXD_div`, which should be used instead of these. `point` is
+// the point of the operands.
+
+// Multiplies two s16s into an s32 with `muls`.
+#define FXD_muls16(num1, num2) ((s32)(s16)(num1) * (s16)(num2))
+// Multiplies two u16s into a u32 with `mulu`.
+#define FXD_mulu16(num1, num2) ((u32)(u16)(num1) * (u16)(num2))
+// Multiplies an s16 by a u16 modulo 2^32. A negative s16 is 2^16 too big when taken as a u16,
+// so the product is `num2 << 16` too big.
+#define FXD_mulsu16(num1, num2) \
+		(FXD_mulu16(num1, num2) - ((s16)(num1) < 0 ? (u32)(u16)(num2) << 16 : 0))
+
+#define FXD_mult16(point, num1, num2) (FXD_muls16(num1, num2) >> (point))
+
+// `num1` is split into a signed high half and an unsigned low half, and since the high half's
+// product is a multiple of 2^16, it can be shifted on its own without changing the flooring.
+// The low half's product fits in an s32 since it's less than 2^16 * 2^15.
+#define FXD_mult32x16(point, num1, num2)									\
+({																			\
+	s32 _n1 = (num1);														\
+	s16 _n2 = (num2);														\
+	(s32)(((u32)FXD_muls16(_n1 >> 16, _n2) << (16 - (point))) +				\
+			(u32)((s32)FXD_mulsu16(_n2, _n1) >> (point)));					\
+})
+
+// Both numbers are split into halves. The middle products can overflow, but only their low
+// bits are kept anyway. The high product is shifted in two steps so that it disappears
+// entirely when `point` is zero, and the low product is unsigned, so it's shifted logically.
+#define FXD_mult32(point, num1, num2)										\
+({																			\
+	s32 _n1 = (num1);														\
+	s32 _n2 = (num2);														\
+	u32 _high = (u32)FXD_muls16(_n1 >> 16, _n2 >> 16) << (31 - (point)) << 1;	\
+	u32 _mid = FXD_mulsu16(_n1 >> 16, _n2) + FXD_mulsu16(_n2 >> 16, _n1);	\
+	(s32)(_high + (_mid << (16 - (point))) + (FXD_mulu16(_n1, _n2) >> (point)));	\
+})
+
+// Divides a u32 by a u16 with `divu`, which gives a 16 bit quotient and a 16 bit remainder,
+// so the quotient must fit in 16 bits. Sets `rem` to the remainder and returns the quotient.
+// Computers get the same thing in C.
+#ifdef __mc68000__
+#define FXD_divu16(num, den, rem)											\
+({																			\
+	u32 _divu = (num);														\
+	asm("divu.w %1,%0" : "+d" (_divu) : "dm" ((u16)(den)));					\
+	(rem) = _divu >> 16;													\
+	(u16)_divu;																\
+})
+#else
+#define FXD_divu16(num, den, rem)											\
+({																			\
+	u32 _divu = (num);														\
+	u16 _divu_den = (den);													\
+	(rem) = _divu % _divu_den;												\
+	(u16)(_divu / _divu_den);												\
+})
+#endif
+
+// Divides a u32 by a u16 like long division with 16 bit digits, skipping the high digit if
+// it's zero. Each `divu` fits, since the remainder carried into it is less than the divisor.
+#define FXD_divu32x16(num, den, rem)										\
+({																			\
+	u32 _num = (num);														\
+	u16 _den = (den);														\
+	u16 _high = 0;															\
+	u16 _high_rem = _num >> 16;												\
+	if (_high_rem >= _den)													\
+		_high = FXD_divu16(_high_rem, _den, _high_rem);						\
+	((u32)_high << 16) | FXD_divu16(((u32)_high_rem << 16) | (u16)_num, _den, rem);	\
+})
+
+// Divides the magnitudes of two numbers, given as unsigned integers of type `utype`, and
+// applies the sign. Each fractional bit doubles the remainder, which stays below the divisor,
+// so it can't overflow `utype`.
+#define FXD_divMagnitude(utype, point, num1, num2)							\
+({																			\
+	utype _mag1 = (num1) < 0 ? -(utype)(num1) : (utype)(num1);				\
+	utype _mag2 = (num2) < 0 ? -(utype)(num2) : (utype)(num2);				\
+	utype _rem;																\
+	u32 _quot;																\
+	if (sizeof(utype) <= 2 || (u32)_mag2 >> 16 == 0) {						\
+		u16 _rem16;															\
+		_quot = FXD_divu32x16(_mag1, _mag2, _rem16);						\
+		_rem = _rem16;														\
+	} else {																\
+		_rem = _mag1 % _mag2;												\
+		_quot = _mag1 / _mag2;												\
+	}																		\
+	for (u8 _bit = (point); _bit != 0; _bit--) {							\
+		_rem <<= 1;															\
+		_quot <<= 1;														\
+		if (_rem >= _mag2) {												\
+			_rem -= _mag2;													\
+			_quot |= 1;														\
+		}																	\
+	}																		\
+	(s32)(((num1) < 0) != ((num2) < 0) ? -_quot : _quot);					\
+})
+
+#define FXD_div16(point, num1, num2) FXD_divMagnitude(u16, point, (s16)(num1), (s16)(num2))
+#define FXD_div32(point, num1, num2) FXD_divMagnitude(u32, point, (s32)(num1), (s32)(num2))
 
 // Create a fixed point number "literal" from a integer literal. Only use with number literals;
 // for variables, always use `FXD_convert` This macro is not necessary if `<type>_POINT` is 0
@@ -191,6 +332,24 @@ register s32 Debug asm("d7");
 	ngetchx();											\
 })
 
+// Byte order:
+/*
+	The calculator is big endian, and the gray planes and tile buffer are laid out so that the
+	leftmost pixel of a byte is its most significant bit. Code that reads or writes that memory
+	with u16s or u32s relies on this to keep pixels in order. The host build (see `host/`) might
+	be little endian, so such values must be passed through `COM_be16` or `COM_be32`, which swap
+	the bytes on little endian hosts and do nothing at all on the calculator. Data that can't
+	just be swapped, like bitfields, can check for `COM_LITTLE_ENDIAN` instead.
+*/
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define COM_LITTLE_ENDIAN
+#define COM_be16(n) __builtin_bswap16(n)
+#define COM_be32(n) __builtin_bswap32(n)
+#else
+#define COM_be16(n) (n)
+#define COM_be32(n) (n)
+#endif
+
 // Error handling
 /*
 	To throw an error, use COM_throwErr with a COM_Error and an optional extra information
@@ -206,7 +365,8 @@ enum COM_Error
 	COM_Error_NONE,   // No error. Do NOT throw this; it's only for use with local variables.
 	COM_Error_OTHER,  // Error not in this list; use info to describe the error.
 	COM_Error_MEMORY, // Heap allocation failed; use info for the allocation that failed.
-	COM_Error_FILE    // File could not be found; use info for the filename.
+	COM_Error_FILE,   // File could not be found; use info for the filename.
+	COM_Error_FORMAT  // File is corrupt or of the wrong version; use info for the filename.
 };
 
 // A global variable which can be set to a string further describing the error in COM_Error.
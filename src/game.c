@@ -10,6 +10,15 @@ char *ErrorInfo = NULL;
 #ifdef DEBUG
 #warning Debugging is enabled with a reserved register.
 #endif
+#ifdef PROFILE
+#warning Profiling is enabled, which stops AMS timers while playing.
+#endif
+#ifdef REPLAY
+#warning Replaying is enabled, which ignores the keyboard while there is a replay file.
+#endif
+#ifdef RECORD
+#warning Recording is enabled, which saves the keys of every level played.
+#endif
 
 // Messages for each error code in GME_Error.
 const char *ErrorMessages[] = {
@@ -17,6 +26,7 @@ const char *ErrorMessages[] = {
 	NULL,
 	"Not enough memory for:",
 	"File not found:",
+	"File is invalid or outdated:",
 };
 
 void GME_LVL_init(struct GME_Game *game)
@@ -27,8 +37,43 @@ void GME_LVL_init(struct GME_Game *game)
 	GME_deInitState(game);
 	game->State = GME_State_LEVEL;
 
-	MAP_init(map);
+	MAP_init(map, "sgl\\level");
+	// The map works the same without the guard border or window, just slower, so failing is
+	// fine. The level is read from the file then, where `MAP_setTile` refuses to change tiles.
+	MAP_initStorage(map);
+	// Likewise, collision reads the tiles without the grid.
+	MAP_initCollisions(map);
+
+	// The player comes before the other objects, which may be left out if there's no file.
+	u16 num_objs = map->Player != NULL ? map->NumObjs + 1 : 0;
+	struct OBJ_Objects *objs = &level->Objs;
+	OBJ_init(objs, num_objs + GME_LVL_SPAWN_ROOM, GME_LVL_MAX_ACTIVE);
+
+	// Map files are saved with their objects sorted, so each one goes right of the last.
+	u16 last = SLL_NULL;
+	for (u16 i = 0; i < num_objs; i++) {
+		const struct MAP_Obj *map_obj = i == 0 ? map->Player : &map->Objs[i - 1];
+		if (map_obj->Type >= OBJ_Type_LEN)
+			COM_throwErr(COM_Error_FORMAT, "map objects");
+
+		struct OBJ_Object obj;
+		OBJ_initFromMap(&obj, map_obj);
+		last = SLL_OBJ_Object_add(&objs->List, &obj, last);
+	}
+	level->DrawFirst = objs->List.Base.First;
+
+#if defined(REPLAY) && defined(RECORD)
+	if (INP_initReplay(&level->Input, GME_LVL_REPLAY_FILE))
+		INP_initRecord(&level->Input, GME_LVL_RECORD_RUNS);
+#elif defined(REPLAY)
+	INP_initReplay(&level->Input, GME_LVL_REPLAY_FILE);
+#elif defined(RECORD)
+	INP_initRecord(&level->Input, GME_LVL_RECORD_RUNS);
+#else
+	INP_init(&level->Input);
+#endif
 
+	SCR_TB_initLevel(&game->Screen, map);
 	SCR_TB_drawAllTiles(&game->Screen, map, 0, 0);
 }
 
@@ -36,53 +81,154 @@ void GME_LVL_deInit(struct GME_Game *game)
 {
 	struct GME_Level *level = &game->Level;
 
+	// The recording is only a convenience, so it doesn't matter if it can't be saved.
+	if (level->Input.Mode == INP_Mode_RECORD)
+		INP_save(&level->Input, GME_LVL_RECORD_FILE);
+	INP_deInit(&level->Input);
+
+	SCR_TB_deInitLevel(&game->Screen);
+	OBJ_deInit(&level->Objs);
 	MAP_deInit(&level->Map);
 
 	COM_zero(level);
 }
 
+void GME_LVL_updateObjects(struct GME_Level *level)
+{
+	MAP_Pos left = FXD_convert(MAP_Scroll, MAP_Pos, level->Map.ScrollX) - GME_LVL_ACTIVE_MARGIN;
+	OBJ_setActiveRange(&level->Objs, left,
+			left + SCR_WIDTH / SCR_SPRITE_SIZE + 2 * GME_LVL_ACTIVE_MARGIN);
+	OBJ_moveActive(&level->Objs);
+}
+
+// Column of the object `index`
+#define objColumn(list, index) OBJ_getColumn(&(list)->Items[index])
+
+// Draws the objects from `first` rightwards that are left of the column `end`, skipping those
+// left of the column `start`.
+static void drawRun(struct SCR_Screen *screen, const struct GME_Level *level, u16 first,
+		MAP_Pos start, MAP_Pos end)
+{
+	const struct OBJ_Objects *objs = &level->Objs;
+	const SLL_List(OBJ_Object) *list = &objs->List;
+
+	for (u16 i = first; i != SLL_NULL && objColumn(list, i) < end;
+			i = list->Base.Links[i].Right) {
+		if (objColumn(list, i) < start)
+			continue;
+
+		// Active objects are drawn from a copy that has their position.
+		if (objs->Active.Slots[i] == SLL_NULL) {
+			SCR_drawObject(screen, &level->Map, &list->Items[i]);
+		} else {
+			struct OBJ_Object obj;
+			OBJ_get(objs, i, &obj);
+			SCR_drawObject(screen, &level->Map, &obj);
+		}
+	}
+}
+
+void GME_LVL_drawObjects(struct SCR_Screen *screen, struct GME_Level *level)
+{
+	const struct MAP_Map *map = &level->Map;
+	const SLL_List(OBJ_Object) *list = &level->Objs.List;
+	const struct SLL_Links *links = list->Base.Links;
+
+	// Objects in the columns from `left` up to `right` might be on the screen. `SCR_drawObject`
+	// skips the ones that turn out not to be.
+	MAP_Pos left = FXD_convert(MAP_Scroll, MAP_Pos, map->ScrollX - OBJ_MAX_WIDTH);
+	MAP_Pos right = FXD_convert(MAP_Scroll, MAP_Pos, map->ScrollX + SCR_WIDTH - 1) + 1;
+
+	// Step left over objects that came into range, and then right over ones that left it.
+	u16 first = level->DrawFirst;
+	u16 prev = first == SLL_NULL ? list->Base.Last : links[first].Left;
+	while (prev != SLL_NULL && objColumn(list, prev) >= left) {
+		first = prev;
+		prev = links[prev].Left;
+	}
+	while (first != SLL_NULL && objColumn(list, first) < left)
+		first = links[first].Right;
+	level->DrawFirst = first;
+
+	if (map->WrapX != MAP_Wrap_LEVEL) {
+		drawRun(screen, level, first, left, right);
+		return;
+	}
+
+	// In levels that wrap, objects at the other end of the level can be seen across its edge.
+	// `SCR_drawObject` draws them there, but they are out of the range above, so they're found
+	// from the ends of the list. Objects in that range are left out so they aren't drawn twice.
+	// The camera can only be past the edge by a little, so few objects are skipped because their
+	// copy is past the other side of the screen instead.
+	MAP_Pos level_x = map->SizeX;
+	MAP_Pos start = COM_max(left + level_x, right);
+
+	u16 last_run = SLL_NULL;
+	for (u16 i = list->Base.Last; i != SLL_NULL && objColumn(list, i) >= start;
+			i = links[i].Left)
+		last_run = i;
+
+	drawRun(screen, level, list->Base.First, left - level_x, COM_min(right - level_x, left));
+	drawRun(screen, level, first, left, right);
+	drawRun(screen, level, last_run, start, right + level_x);
+}
+
 void GME_LVL_loop(struct GME_Game *game)
 {
 	struct MAP_Map *map = &game->Level.Map;
 	struct SCR_Screen *screen = &game->Screen;
+	struct INP_Input *input = &game->Level.Input;
+
+	PRF_startFrame(&game->Profiler);
 
-	if (_keytest(RR_ESC)) {
-		game->State = GME_State_NONE;
+	PRF_time(&game->Profiler, PRF_Phase_INPUT, INP_update(input));
+
+	// Deinitializing the level rather than just leaving it saves the recording, if any.
+	if (INP_isDown(input, INP_Key_ESC) || (input->Done && input->Mode == INP_Mode_REPLAY)) {
+		GME_deInitState(game);
 		return;
 	}
 
-	if (_keytest(RR_BCKSPC)) {
-		SCR_scrollAbsolute(screen, map, 0, 0);
+	PRF_time(&game->Profiler, PRF_Phase_OBJ_UPDATE, GME_LVL_updateObjects(&game->Level));
+
+	if (INP_isDown(input, INP_Key_BCKSPC)) {
+		PRF_time(&game->Profiler, PRF_Phase_SCROLL, SCR_scrollAbsolute(screen, map, 0, 0));
 	} else {
 		MAP_Scroll speed = 1;
-		if (_keytest(RR_DIAMOND))
+		if (INP_isDown(input, INP_Key_DIAMOND))
 			speed = 8;
 
 		MAP_Scroll shift_x = 0;
 		MAP_Scroll shift_y = 0;
 
-		if (_keytest(RR_RIGHT))
+		if (INP_isDown(input, INP_Key_RIGHT))
 			shift_x += speed;
-		if (_keytest(RR_LEFT))
+		if (INP_isDown(input, INP_Key_LEFT))
 			shift_x -= speed;
 
-		if (_keytest(RR_DOWN))
+		if (INP_isDown(input, INP_Key_DOWN))
 			shift_y += speed;
-		if (_keytest(RR_UP))
+		if (INP_isDown(input, INP_Key_UP))
 			shift_y -= speed;
 
-		SCR_scroll(screen, map, shift_x, shift_y);
+		PRF_time(&game->Profiler, PRF_Phase_SCROLL, SCR_scroll(screen, map, shift_x, shift_y));
 	}
 
-	SCR_drawTileBuffer(screen,
-			FXD_numer(MAP_Scroll, map->ScrollX), FXD_numer(MAP_Scroll, map->ScrollY));
+	PRF_time(&game->Profiler, PRF_Phase_ANIM, SCR_TB_updateAnimatedTiles(screen));
+	PRF_time(&game->Profiler, PRF_Phase_BLIT, SCR_drawTileBuffer(screen,
+			FXD_numer(MAP_Scroll, map->ScrollX), FXD_numer(MAP_Scroll, map->ScrollY)));
+	PRF_time(&game->Profiler, PRF_Phase_OBJ_DRAW, GME_LVL_drawObjects(screen, &game->Level));
+
+	PRF_drawHud(&game->Profiler);
+	PRF_time(&game->Profiler, PRF_Phase_SWAP, SCR_swap());
 
-	SCR_swap();
+	PRF_endFrame(&game->Profiler);
 }
 
 void GME_init(struct GME_Game *game)
 {
 	SCR_init(&game->Screen);
+	PRF_init(&game->Profiler);
 
 	GME_LVL_init(game);
 }
@@ -90,6 +236,7 @@ void GME_init(struct GME_Game *game)
 void GME_deInit(struct GME_Game *game)
 {
 	GME_deInitState(game);
+	PRF_deInit(&game->Profiler);
 	SCR_deInit(&game->Screen);
 
 	COM_zero(game);
@@ -6,7 +6,10 @@
 
 #include "common.h"
 
+#include "input.h"
 #include "map.h"
+#include "object.h"
+#include "profile.h"
 #include "screen.h"
 
 // GME Namespace: Main game handling and data
@@ -60,12 +63,41 @@ struct GME_Level
 {
 	// The static map data
 	struct MAP_Map Map;
-	// The dynamically sorted list of objects
-	// struct SOL_List Objs;
+	// The dynamically sorted list of objects, and the positions and velocities of the active
+	// ones
+	struct OBJ_Objects Objs;
+	// The leftmost object that might be on the screen, or SLL_NULL if every object is left of
+	// it. It follows the screen as it scrolls. Like any index of an object, it must be changed
+	// if the object it points to is moved by removing another.
+	u16 DrawFirst;
+	// The keys for each frame, which are read live. They are replayed from GME_LVL_REPLAY_FILE
+	// instead if REPLAY is defined and it exists, and otherwise recorded to GME_LVL_RECORD_FILE
+	// if RECORD is defined.
+	struct INP_Input Input;
 };
 
+// How many objects can be spawned in a level besides the ones in its map
+#define GME_LVL_SPAWN_ROOM 64
+// How many objects can be active at once, and how many columns past each side of the screen
+// they are active in
+#define GME_LVL_MAX_ACTIVE 64
+#define GME_LVL_ACTIVE_MARGIN 8
+
+#define GME_LVL_REPLAY_FILE "sgl\\replay"
+#define GME_LVL_RECORD_FILE "sgl\\lastrun"
+// How many runs of keys are recorded before recording stops, which is many minutes of play
+#define GME_LVL_RECORD_RUNS 2048
+
 void GME_LVL_init(struct GME_Game *game);
 void GME_LVL_deInit(struct GME_Game *game);
+// Makes the objects around the screen active and moves them by their velocities. Objects seen
+// across the edge of a level that wraps aren't made active.
+void GME_LVL_updateObjects(struct GME_Level *level);
+// Draws the objects of the level that might be on the screen, in the order of the list. They
+// are sorted by column, so only the ones from the column `OBJ_MAX_WIDTH` left of the screen
+// to the column of its right edge are looked at, and `DrawFirst` is kept from the last frame,
+// so finding the first of them only steps over the objects that have crossed that edge since.
+void GME_LVL_drawObjects(struct SCR_Screen *screen, struct GME_Level *level);
 void GME_LVL_loop(struct GME_Game *game);
 
 // A struct containing all the data relevant to the level editor.
@@ -74,7 +106,7 @@ struct GME_Editor
 	// The static map data
 	struct MAP_Map Map;
 	// The dynamically sorted list of map objects
-	// struct SLL(MAP_Obj)_List Objs;
+	SLL_List(MAP_Obj) Objs;
 };
 
 #define GME_EDT_init(game)
@@ -98,6 +130,10 @@ struct GME_Game
 	};
 	// The screen information, common to all states.
 	struct SCR_Screen Screen;
+#ifdef PROFILE
+	// The frame profiler, which only exists when profiling is enabled.
+	struct PRF_Profiler Profiler;
+#endif
 };
 
 // Initializes the shared components of the game, but none of the specific states, which must
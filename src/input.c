@@ -0,0 +1,162 @@
+// Super Grayland: Copyright 2021 Vincent Robinson under the zlib license.
+// See `license.txt` for more information.
+// Before delving into the code, please read `readme_source.txt` to understand the basic design.
+
+#include "input.h"
+
+void INP_init(struct INP_Input *input)
+{
+	COM_zero(input);
+	input->Mode = INP_Mode_LIVE;
+}
+
+void INP_initRecord(struct INP_Input *input, u16 cap)
+{
+	INP_init(input);
+
+	input->Runs = HeapAllocPtr(sizeof(struct INP_Run) * (u32)cap);
+	if (input->Runs == NULL)
+		COM_throwErr(COM_Error_MEMORY, "input recording");
+
+	input->Mode = INP_Mode_RECORD;
+	input->Cap = cap;
+}
+
+bool INP_initReplay(struct INP_Input *input, const char *name)
+{
+	INP_init(input);
+
+	if (FOpen(name, &input->File, FM_READ, "sgli") != FS_OK) {
+		COM_zero(&input->File);
+		return TRUE;
+	}
+
+	// The first two bytes of a variable are its size.
+	u8 *data = HeapDeref(input->File.dataH);
+	u16 size = COM_be16(*(const u16 *)data);
+	data += 2;
+
+	const struct INP_FileHeader *header = (const struct INP_FileHeader *)data;
+	if (size < sizeof(*header) || memcmp(header->Magic, "SGLI", 4) != 0 ||
+			COM_be16(header->Version) != INP_FILE_VERSION)
+		COM_throwErr(COM_Error_FORMAT, (char *)name);
+
+	input->Runs = (struct INP_Run *)(header + 1);
+	input->NumRuns = COM_be16(header->NumRuns);
+	if (sizeof(*header) + (u32)sizeof(struct INP_Run) * input->NumRuns > size)
+		COM_throwErr(COM_Error_FORMAT, (char *)name);
+
+	input->Mode = INP_Mode_REPLAY;
+	input->Done = input->NumRuns == 0;
+	return FALSE;
+}
+
+void INP_deInit(struct INP_Input *input)
+{
+	if (input->Mode == INP_Mode_RECORD && input->Runs != NULL)
+		HeapFreePtr(input->Runs);
+	if (input->File.dataH != H_NULL)
+		FClose(&input->File);
+
+	COM_zero(input);
+}
+
+// Reads every key that the game uses from the keyboard.
+static u16 readKeys(void)
+{
+	u16 keys = 0;
+
+#define readKey(key, rr_key)		\
+	if (_keytest(rr_key))			\
+		keys |= 1 << INP_Key_##key;
+
+	readKey(UP, RR_UP);
+	readKey(DOWN, RR_DOWN);
+	readKey(LEFT, RR_LEFT);
+	readKey(RIGHT, RR_RIGHT);
+	readKey(DIAMOND, RR_DIAMOND);
+	readKey(ESC, RR_ESC);
+	readKey(BCKSPC, RR_BCKSPC);
+
+#undef readKey
+
+	return keys;
+}
+
+// Adds the keys of this frame to the last run if they're the same or starts a new run if not.
+static void record(struct INP_Input *input)
+{
+	if (input->Done)
+		return;
+
+	if (input->NumRuns != 0) {
+		struct INP_Run *last = &input->Runs[input->NumRuns - 1];
+		if (last->Keys == input->Keys && last->Frames != 0xFFFF) {
+			last->Frames++;
+			return;
+		}
+	}
+
+	if (input->NumRuns == input->Cap) {
+		input->Done = TRUE;
+		return;
+	}
+
+	input->Runs[input->NumRuns++] = (struct INP_Run){.Keys = input->Keys, .Frames = 1};
+}
+
+// Takes the keys of this frame from the file, moving on to the next run once all of the frames
+// of this one have been played.
+static void replay(struct INP_Input *input)
+{
+	input->Keys = 0;
+
+	// Runs of zero frames are skipped.
+	while (!input->Done && input->Frame >= COM_be16(input->Runs[input->Run].Frames)) {
+		input->Frame = 0;
+		input->Done = ++input->Run == input->NumRuns;
+	}
+	if (input->Done)
+		return;
+
+	input->Keys = COM_be16(input->Runs[input->Run].Keys);
+	input->Frame++;
+}
+
+void INP_update(struct INP_Input *input)
+{
+	if (input->Mode == INP_Mode_REPLAY) {
+		replay(input);
+		return;
+	}
+
+	input->Keys = readKeys();
+	if (input->Mode == INP_Mode_RECORD)
+		record(input);
+}
+
+bool INP_save(const struct INP_Input *input, const char *name)
+{
+	FILES file;
+	if (FOpen(name, &file, FM_WRITE, "sgli") != FS_OK)
+		return TRUE;
+
+	struct INP_FileHeader header = {
+		.Magic = {'S', 'G', 'L', 'I'},
+		.Version = COM_be16(INP_FILE_VERSION),
+		.NumRuns = COM_be16(input->NumRuns)
+	};
+	bool failed = FWrite(&header, sizeof(header), &file) != FS_OK;
+
+	for (u16 i = 0; i < input->NumRuns && !failed; i++) {
+		struct INP_Run run = {
+			.Keys = COM_be16(input->Runs[i].Keys),
+			.Frames = COM_be16(input->Runs[i].Frames)
+		};
+		failed = FWrite(&run, sizeof(run), &file) != FS_OK;
+	}
+
+	if (FClose(&file) != FS_OK)
+		failed = TRUE;
+	return failed;
+}
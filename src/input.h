@@ -0,0 +1,118 @@
+// Super Grayland: Copyright 2021 Vincent Robinson under the zlib license.
+// See `license.txt` for more information.
+// Before delving into the code, please read `readme_source.txt` to understand the basic design.
+
+#pragma once
+
+#include "common.h"
+
+// INP Namespace: Player input
+/*
+	The game never reads the keyboard with `_keytest` directly. Instead, `INP_update` reads
+	every key that the game uses once at the start of each frame into a bitmask of `INP_Key`s,
+	which the rest of the frame checks with `INP_isDown`.
+
+	That bitmask can come from three places, depending on the mode of the `INP_Input`:
+	* `INP_Mode_LIVE` reads the keyboard.
+	* `INP_Mode_RECORD` reads the keyboard and also records the keys of every frame, which can
+	  be saved to a file with `INP_save` afterwards.
+	* `INP_Mode_REPLAY` plays back the keys of a saved file instead, so exactly the same game is
+	  played again. This is how the speed of two builds can be compared fairly.
+
+	Keys usually stay the same for many frames at a time, so they are recorded as runs of
+	frames with the same keys rather than frame by frame.
+
+	Replaying and recording are for testing, so release builds always read the keyboard live.
+	Levels are only replayed from a replay file when the REPLAY macro is defined, since a
+	leftover file would otherwise make every level ignore the keyboard. Recording takes memory
+	for the runs and writes a file at the end of every level, so levels are only recorded when
+	the RECORD macro is defined. A warning is issued for each one that is. With both, levels are
+	replayed if there is a replay file and recorded otherwise.
+*/
+// #define REPLAY
+// #define RECORD
+
+// Keys that the game reads, which are bits in `INP_Input.Keys`
+enum INP_Key
+{
+	INP_Key_UP,
+	INP_Key_DOWN,
+	INP_Key_LEFT,
+	INP_Key_RIGHT,
+	INP_Key_DIAMOND,
+	INP_Key_ESC,
+	INP_Key_BCKSPC,
+	INP_Key_LEN
+};
+
+// Whether `key` is pressed in this frame
+#define INP_isDown(input, key) (((input)->Keys & (1 << (key))) != 0)
+
+// A number of frames in a row with the same keys pressed
+struct INP_Run
+{
+	u16 Keys;
+	u16 Frames;
+};
+
+// Input files:
+/*
+	Recorded input is stored in `sgli` files, which are read in place like maps. All numbers
+	are big endian. They hold:
+	* The `INP_FileHeader`.
+	* `NumRuns` `INP_Run`s.
+*/
+#define INP_FILE_VERSION 1
+
+struct INP_FileHeader
+{
+	char Magic[4]; // "SGLI"
+	u16 Version;
+	u16 NumRuns;
+};
+
+enum INP_Mode
+{
+	INP_Mode_LIVE,
+	INP_Mode_RECORD,
+	INP_Mode_REPLAY
+};
+
+struct INP_Input
+{
+	// The keys pressed in this frame
+	u16 Keys;
+
+	enum INP_Mode Mode;
+
+	// The recorded runs, or the runs in the file being replayed. Replayed runs are big endian.
+	struct INP_Run *Runs;
+	u16 NumRuns;
+	// How many runs there is room for when recording
+	u16 Cap;
+
+	// The run being replayed and how many of its frames have been played
+	u16 Run;
+	u16 Frame;
+	// TRUE once every run has been replayed or there is no more room to record
+	bool Done;
+
+	// The file being replayed
+	FILES File;
+};
+
+// Reads the keyboard without recording it.
+void INP_init(struct INP_Input *input);
+// Reads the keyboard and records up to `cap` runs. Throws an error if there isn't enough
+// memory.
+void INP_initRecord(struct INP_Input *input, u16 cap);
+// Replays the input file `name`. Returns TRUE if it doesn't exist, leaving `input` reading the
+// keyboard instead, and throws an error if it is corrupt.
+bool INP_initReplay(struct INP_Input *input, const char *name);
+void INP_deInit(struct INP_Input *input);
+
+// Reads the keys for the next frame. When a replay is done, no keys are pressed.
+void INP_update(struct INP_Input *input);
+
+// Saves the recorded input to the file `name`. Returns TRUE if it couldn't be written.
+bool INP_save(const struct INP_Input *input, const char *name);
@@ -5,17 +5,19 @@
 #include "map.h"
 
 // Load a temporary test map
-struct MAP_TileDef TEMP_DEFS[4] = {
+struct MAP_TileDef TEMP_DEFS[5] = {
 	{0, 0, 0, MAP_Collision_AIR, MAP_Property_NORMAL},
 	{3, 1, 0, MAP_Collision_SOLID, MAP_Property_NORMAL},
-	{2, 0, 0, MAP_Collision_AIR, MAP_Property_NORMAL},
-	{1, 0, 0, MAP_Collision_CLOUD, MAP_Property_NORMAL}
+	{2, 0, 0, MAP_Collision_AIR, MAP_Property_NORMAL, TRUE, FALSE},
+	{1, 0, 0, MAP_Collision_CLOUD, MAP_Property_NORMAL},
+	{0, 4, 0, MAP_Collision_AIR, MAP_Property_NORMAL, FALSE, TRUE}
 };
 
 #define _ 0
 #define x 1
 #define t 2
 #define o 3
+#define a 4
 
 MAP_TileIndex TEMP_INDICES[40 * 20] = {
 	_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,
@@ -23,7 +25,7 @@ MAP_TileIndex TEMP_INDICES[40 * 20] = {
 	_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,
 	_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,x,x,_,x,x,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,
 	_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,x,_,_,_,x,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,
-	_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,
+	_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,a,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,
 	_,_,_,_,_,_,_,_,_,_,_,o,o,o,o,o,o,o,o,x,_,_,_,x,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,
 	_,_,_,_,_,_,_,_,_,_,_,_,t,_,_,_,_,t,_,x,x,_,x,x,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,
 	_,_,_,_,x,_,_,_,_,_,_,_,t,_,_,_,_,t,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,
@@ -32,7 +34,7 @@ MAP_TileIndex TEMP_INDICES[40 * 20] = {
 	_,_,_,_,x,_,_,_,_,_,_,_,_,_,_,_,_,t,_,_,_,_,_,_,_,_,_,x,x,x,x,_,_,_,_,_,_,_,_,x,
 	_,_,_,_,x,_,_,_,_,_,_,_,_,_,_,_,_,o,_,_,_,_,_,_,_,_,x,_,_,_,_,_,_,_,_,_,_,_,_,x,
 	_,_,_,_,x,_,_,_,_,_,_,_,_,_,_,_,_,t,_,_,_,_,_,_,_,x,_,_,_,_,_,_,_,_,_,_,_,_,_,x,
-	_,_,_,_,x,_,_,_,_,_,_,_,_,_,_,x,x,x,x,x,x,x,x,x,x,_,_,_,_,_,_,_,_,_,_,_,_,_,_,x,
+	_,_,_,_,x,_,_,_,_,_,_,_,a,_,_,x,x,x,x,x,x,x,x,x,x,_,_,_,_,_,_,_,_,_,_,_,_,_,_,x,
 	_,_,_,_,x,_,_,_,_,_,_,_,_,_,_,_,_,t,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,x,_,_,_,x,
 	_,_,_,_,x,_,_,_,_,_,_,_,_,_,_,_,_,t,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,x,_,_,_,x,
 	_,_,_,_,x,_,_,_,_,_,_,_,_,_,_,_,_,t,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,x,_,_,x,
@@ -40,33 +42,354 @@ MAP_TileIndex TEMP_INDICES[40 * 20] = {
 	x,x,x,x,x,_,_,_,_,_,_,_,_,_,_,_,_,t,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,_,x,x,x,x,
 };
 
-void MAP_init(struct MAP_Map *map)
+// Points the map into the map file `name`. Returns TRUE if there is no such file.
+static bool openMap(struct MAP_Map *map, const char *name)
 {
-	map->Defs = TEMP_DEFS;
-	map->Indices = TEMP_INDICES;
+	if (FOpen(name, &map->File, FM_READ, "sglm") != FS_OK) {
+		COM_zero(&map->File);
+		return TRUE;
+	}
+
+	// The first two bytes of a variable are its size.
+	const u8 *data = HeapDeref(map->File.dataH);
+	u16 size = COM_be16(*(const u16 *)data);
+	data += 2;
+
+	const struct MAP_FileHeader *header = (const struct MAP_FileHeader *)data;
+	if (size < sizeof(*header) || memcmp(header->Magic, "SGLM", 4) != 0 ||
+			COM_be16(header->Version) != MAP_FILE_VERSION)
+		COM_throwErr(COM_Error_FORMAT, (char *)name);
+
+	u16 size_x = COM_be16(header->SizeX);
+	u16 size_y = COM_be16(header->SizeY);
+	u16 num_defs = COM_be16(header->NumDefs);
+
+	if (size_x == 0 || size_x > 0x7FFF || size_y == 0 || size_y > 0x7FFF || num_defs == 0 ||
+			num_defs > 255 || header->WrapX > MAP_Wrap_LEVEL || header->WrapY > MAP_Wrap_LEVEL)
+		COM_throwErr(COM_Error_FORMAT, (char *)name);
+
+	// Find each section and check that they all fit in the file. Sections with an odd size are
+	// padded so that the next one starts at an even offset.
+	u32 used = sizeof(*header);
+
+	const u8 *defs = data + used;
+	used += (u32)sizeof(struct MAP_TileDef) * num_defs;
+
+	map->Indices = (MAP_TileIndex *)(data + used);
+	map->ReadOnly = TRUE;
+	used += ((u32)size_x * size_y + 1) & ~(u32)1;
+
+	map->Player = (const struct MAP_Obj *)(data + used);
+	map->Objs = map->Player + 1;
+	map->NumObjs = COM_be16(header->NumObjs);
+	used += (u32)sizeof(struct MAP_Obj) * (map->NumObjs + 1);
+
+	map->Specials = data + used;
+	map->NumSpecials = COM_be16(header->NumSpecials);
+	used += (u32)MAP_SPECIAL_SIZE * map->NumSpecials;
+
+	map->Name = (const char *)(data + used);
+	map->NameLength = header->NameLength;
+	used += (map->NameLength + 1) & ~1;
 
-	map->SizeX = 40;
-	map->SizeY = 20;
+	map->Text = (const char *)(data + used);
+	map->TextSize = COM_be16(header->TextSize);
+	used += map->TextSize;
+
+	if (used > size)
+		COM_throwErr(COM_Error_FORMAT, (char *)name);
+
+#ifdef COM_LITTLE_ENDIAN
+	// The bitfields of a little endian `MAP_TileDef` are in a different order, so the
+	// definitions are unpacked from the 68k layout instead.
+	map->HostDefs = HeapAllocPtr(sizeof(struct MAP_TileDef) * num_defs);
+	if (map->HostDefs == NULL)
+		COM_throwErr(COM_Error_MEMORY, "tile definitions");
+
+	for (u16 i = 0; i < num_defs; i++) {
+		const u8 *it = defs + sizeof(struct MAP_TileDef) * i;
+		struct MAP_TileDef *def = &map->HostDefs[i];
+
+		def->Back = COM_be16(*(const u16 *)it);
+		def->Front = COM_be16(*(const u16 *)(it + 2));
+		def->Special = it[4];
+		def->Collision = it[5] >> 6;
+		def->Property = (it[5] >> 3) & 7;
+		def->IsBackFg = (it[5] >> 2) & 1;
+		def->IsFrontFg = (it[5] >> 1) & 1;
+	}
+
+	map->Defs = map->HostDefs;
+#else
+	map->Defs = (struct MAP_TileDef *)defs;
+#endif
+	map->NumDefs = num_defs;
+
+	map->SizeX = size_x;
+	map->SizeY = size_y;
+
+	map->WrapX = header->WrapX;
+	map->WrapY = header->WrapY;
+
+	map->Act = header->Act;
+	map->Music = header->Music;
+	map->UseRain = (header->Flags & MAP_FileFlag_RAIN) != 0;
+
+	return FALSE;
+}
+
+void MAP_init(struct MAP_Map *map, const char *name)
+{
+	if (openMap(map, name)) {
+		map->Defs = TEMP_DEFS;
+		map->NumDefs = sizeof(TEMP_DEFS) / sizeof(*TEMP_DEFS);
+		map->Indices = TEMP_INDICES;
+
+		map->SizeX = 40;
+		map->SizeY = 20;
+
+		map->WrapX = MAP_Wrap_NONE;
+		map->WrapY = MAP_Wrap_NONE;
+	}
+
+	map->Pitch = map->SizeX;
 
 	map->ScrollX = 0;
 	map->ScrollY = 0;
-
-	map->WrapX = MAP_Wrap_NONE;
-	map->WrapY = MAP_Wrap_NONE;
 }
 
 void MAP_deInit(struct MAP_Map *map)
 {
+	MAP_deInitGuard(map);
+	MAP_deInitStream(map);
+	MAP_deInitCollisions(map);
+
+	if (map->HostDefs != NULL)
+		HeapFreePtr(map->HostDefs);
+	if (map->File.dataH != H_NULL)
+		FClose(&map->File);
+
 	COM_zero(map);
 }
 
+// Map objects are sorted by their big endian X position.
+#define mapObjKey(obj) ((MAP_Pos)COM_be16((obj)->PosX))
+
+SLL_DEFINE(MAP_Obj, mapObjKey)
+
 // Generic tiles for tile collision off the level boundaries
 const struct MAP_TileDef PlainSolid = {.Collision = MAP_Collision_SOLID};
 const struct MAP_TileDef PlainAir   = {.Collision = MAP_Collision_AIR};
 const struct MAP_TileDef DeathAir   = {.Collision = MAP_Collision_AIR, .Property = MAP_Property_DEATH};
 
+bool MAP_initGuard(struct MAP_Map *map)
+{
+	if (map->WrapX || map->WrapY || map->Window != NULL || map->NumDefs > 253)
+		return TRUE;
+
+	MAP_Pos width = map->SizeX + MAP_GUARD * 2;
+	MAP_Pos height = map->SizeY + MAP_GUARD * 2;
+
+	// Everything is in one allocation, starting with the row table since it needs the most
+	// alignment, then the definitions, and then the indices.
+	u32 rows_size = sizeof(MAP_TileIndex *) * height;
+	u32 defs_size = sizeof(struct MAP_TileDef) * (map->NumDefs + 3);
+
+	u8 *mem = HeapAllocPtr(rows_size + defs_size + (u32)width * height);
+	if (mem == NULL)
+		return TRUE;
+
+	MAP_TileIndex **rows = (MAP_TileIndex **)mem;
+	struct MAP_TileDef *defs = (struct MAP_TileDef *)(mem + rows_size);
+	MAP_TileIndex *it = mem + rows_size + defs_size;
+
+	memcpy(defs, map->Defs, sizeof(struct MAP_TileDef) * map->NumDefs);
+	defs[map->NumDefs] = PlainSolid;
+	defs[map->NumDefs + 1] = PlainAir;
+	defs[map->NumDefs + 2] = DeathAir;
+
+	MAP_TileIndex solid = map->NumDefs;
+
+	for (MAP_Pos y = -MAP_GUARD; y < map->SizeY + MAP_GUARD; y++) {
+		*rows++ = it + MAP_GUARD;
+
+		memset(it, solid, MAP_GUARD);
+		if (y < 0)
+			memset(it + MAP_GUARD, solid + 1, map->SizeX);
+		else if (y >= map->SizeY)
+			memset(it + MAP_GUARD, solid + 2, map->SizeX);
+		else
+			memcpy(it + MAP_GUARD, map->Indices + (s32)y * map->Pitch, map->SizeX);
+		memset(it + MAP_GUARD + map->SizeX, solid, MAP_GUARD);
+
+		it += width;
+	}
+
+	map->PlainDefs = map->Defs;
+	map->PlainIndices = map->Indices;
+
+	map->Rows = (MAP_TileIndex **)mem + MAP_GUARD;
+	map->Defs = defs;
+	map->Indices = map->Rows[0];
+	map->Pitch = width;
+
+	return FALSE;
+}
+
+void MAP_deInitGuard(struct MAP_Map *map)
+{
+	if (map->Rows == NULL)
+		return;
+
+	HeapFreePtr(map->Rows - MAP_GUARD);
+
+	map->Defs = map->PlainDefs;
+	map->Indices = map->PlainIndices;
+	map->Pitch = map->SizeX;
+
+	map->Rows = NULL;
+	map->PlainDefs = NULL;
+	map->PlainIndices = NULL;
+}
+
+// Sets the collision of a tile inside the map in the collision grid.
+static void setCollision(struct MAP_Map *map, MAP_Pos pos_x, MAP_Pos pos_y,
+		enum MAP_Collision collision)
+{
+	u8 *byte = map->Collisions + ((u16)pos_y << map->CollisionShift) + ((u16)pos_x >> 2);
+	u8 shift = (~pos_x & 3) << 1;
+
+	*byte = (*byte & ~(3 << shift)) | collision << shift;
+}
+
+// Copies column `pos_x` of the map from `Source` into its place in the window.
+static void pageColumn(struct MAP_Map *map, MAP_Pos pos_x)
+{
+	MAP_TileIndex *column = MAP_getIndex(map, pos_x, 0);
+	MAP_TileIndex *it = column;
+	const MAP_TileIndex *source = map->Source + pos_x;
+
+	for (MAP_Pos i = 0; i < map->SizeY; i++) {
+		*it++ = *source;
+		source += map->Pitch;
+	}
+
+	// Any changes to the column are gone now, so their collision has to go too.
+	if (map->Collisions != NULL) {
+		for (MAP_Pos i = 0; i < map->SizeY; i++)
+			setCollision(map, pos_x, i, map->Defs[column[i]].Collision);
+	}
+}
+
+bool MAP_initStream(struct MAP_Map *map)
+{
+	if (map->WrapX || map->Rows != NULL || map->Window != NULL ||
+			map->SizeX <= MAP_WINDOW_WIDTH)
+		return TRUE;
+
+	u8 shift = 0;
+	while (((u32)1 << shift) < (u32)map->SizeY)
+		shift++;
+
+	// Offsets into the window are 16-bit, which is also the most that can be allocated at once.
+	u32 size = (u32)MAP_WINDOW_WIDTH << shift;
+	if (size > 0xFFFF)
+		return TRUE;
+
+	MAP_TileIndex *window = HeapAllocPtr(size);
+	if (window == NULL)
+		return TRUE;
+
+	map->Source = map->Indices;
+	map->Indices = NULL;
+
+	map->Window = window;
+	map->WindowX = 0;
+	map->WindowShift = shift;
+
+	for (MAP_Pos col = 0; col < MAP_WINDOW_WIDTH; col++)
+		pageColumn(map, col);
+
+	return FALSE;
+}
+
+void MAP_deInitStream(struct MAP_Map *map)
+{
+	if (map->Window == NULL)
+		return;
+
+	HeapFreePtr(map->Window);
+
+	map->Indices = (MAP_TileIndex *)map->Source;
+
+	map->Window = NULL;
+	map->WindowX = 0;
+	map->WindowShift = 0;
+	map->Source = NULL;
+}
+
+bool MAP_initStorage(struct MAP_Map *map)
+{
+	u32 guard_size = (u32)(map->SizeX + MAP_GUARD * 2) * (map->SizeY + MAP_GUARD * 2);
+
+	if (guard_size > HeapAvail() / MAP_GUARD_SHARE)
+		return MAP_initStream(map) && MAP_initGuard(map);
+	return MAP_initGuard(map) && MAP_initStream(map);
+}
+
+void MAP_pageWindow(struct MAP_Map *map, MAP_Pos view_x, MAP_Pos view_width)
+{
+	if (map->Window == NULL)
+		return;
+
+	MAP_Pos first = COM_max(view_x - MAP_WINDOW_MARGIN, 0);
+	MAP_Pos last = COM_min(view_x + view_width + MAP_WINDOW_MARGIN, map->SizeX);
+	MAP_Pos old_x = map->WindowX;
+
+	if (first >= old_x && last <= old_x + MAP_WINDOW_WIDTH)
+		return;
+
+	// Centering the view gives it the most room to move either way before paging again.
+	MAP_Pos window_x = view_x - (MAP_WINDOW_WIDTH - view_width) / 2;
+	window_x = COM_min(COM_max(window_x, 0), map->SizeX - MAP_WINDOW_WIDTH);
+
+	// Columns in both the old and new windows are already where they need to be in the ring.
+	for (MAP_Pos col = window_x; col < window_x + MAP_WINDOW_WIDTH; col++) {
+		if (col < old_x || col >= old_x + MAP_WINDOW_WIDTH)
+			pageColumn(map, col);
+	}
+
+	map->WindowX = window_x;
+}
+
+MAP_TileIndex *MAP_getIndex(struct MAP_Map *map, MAP_Pos pos_x, MAP_Pos pos_y)
+{
+	if (map->Window != NULL)
+		return map->Window +
+				((u16)(pos_x & (MAP_WINDOW_WIDTH - 1)) << map->WindowShift) + pos_y;
+
+	return map->Indices + (s32)pos_y * map->Pitch + pos_x;
+}
+
+bool MAP_setTile(struct MAP_Map *map, MAP_Pos pos_x, MAP_Pos pos_y, MAP_TileIndex index)
+{
+	if (map->ReadOnly && map->Rows == NULL && map->Window == NULL)
+		return TRUE;
+
+	*MAP_getIndex(map, pos_x, pos_y) = index;
+
+	if (map->Collisions != NULL)
+		setCollision(map, pos_x, pos_y, map->Defs[index].Collision);
+	return FALSE;
+}
+
 const struct MAP_TileDef *MAP_getTile(const struct MAP_Map *map, MAP_Pos pos_x, MAP_Pos pos_y)
 {
+	// Comparing as unsigned checks both sides of the border at once.
+	if (map->Rows != NULL && (u16)(pos_x + MAP_GUARD) < (u16)(map->SizeX + MAP_GUARD * 2) &&
+			(u16)(pos_y + MAP_GUARD) < (u16)(map->SizeY + MAP_GUARD * 2))
+		return &map->Defs[map->Rows[pos_y][pos_x]];
+
 	// Handle objects/anything else going out of the level boundaries
 	if (pos_x < 0 || pos_x >= map->SizeX) {
 		if (map->WrapX) {
@@ -94,5 +417,231 @@ const struct MAP_TileDef *MAP_getTile(const struct MAP_Map *map, MAP_Pos pos_x,
 		}
 	}
 
-	return &map->Defs[map->Indices[pos_y * map->SizeX + pos_x]];
+	if (map->Window != NULL) {
+		if ((u16)(pos_x - map->WindowX) >= MAP_WINDOW_WIDTH)
+			return &PlainSolid; // The column isn't in memory
+
+		return &map->Defs[map->Window[
+				((u16)(pos_x & (MAP_WINDOW_WIDTH - 1)) << map->WindowShift) + pos_y]];
+	}
+
+	return &map->Defs[map->Indices[pos_y * map->Pitch + pos_x]];
+}
+
+// Index that every tile off the map reads as, since their `Defs` is the tile itself.
+static const MAP_TileIndex FillIndex = 0;
+
+// Returns `pos` wrapped into [0, `size`).
+static MAP_Pos wrapPos(MAP_Pos pos, MAP_Pos size)
+{
+	pos %= size;
+	return pos < 0 ? pos + size : pos;
+}
+
+void MAP_initSpan(struct MAP_Span *span, const struct MAP_Map *map, MAP_Pos pos_x,
+		MAP_Pos pos_y, u16 length, enum MAP_SpanDir dir)
+{
+	const struct MAP_TileDef *line_fill = NULL;
+
+	// Find the row or column the span is in first. As in `MAP_getTile`, being to the side of a
+	// non-wrapping map takes precedence over being above or below it.
+	if (dir == MAP_SpanDir_RIGHT) {
+		span->Pos = pos_x;
+		span->Size = map->SizeX;
+		span->Wraps = map->WrapX;
+		span->FillBefore = span->FillAfter = &PlainSolid;
+
+		if (pos_y < 0 || pos_y >= map->SizeY) {
+			if (map->WrapY)
+				pos_y = wrapPos(pos_y, map->SizeY);
+			else
+				line_fill = pos_y < 0 ? &PlainAir : &DeathAir;
+		}
+
+		if (map->Window != NULL) {
+			span->Line = map->Window + pos_y;
+			span->LineStride = 1 << map->WindowShift;
+			span->Ring = MAP_WINDOW_WIDTH;
+		} else {
+			span->Line = map->Indices + (s32)pos_y * map->Pitch;
+			span->LineStride = 1;
+			span->Ring = 0;
+		}
+	} else {
+		span->Pos = pos_y;
+		span->Size = map->SizeY;
+		span->Wraps = map->WrapY;
+		span->FillBefore = &PlainAir;
+		span->FillAfter = &DeathAir;
+
+		if (pos_x < 0 || pos_x >= map->SizeX) {
+			if (map->WrapX) {
+				pos_x = wrapPos(pos_x, map->SizeX);
+			} else {
+				// The whole column is solid, including above and below the map.
+				line_fill = span->FillBefore = span->FillAfter = &PlainSolid;
+			}
+		}
+
+		if (map->Window != NULL) {
+			span->Line = map->Window +
+					((u16)(pos_x & (MAP_WINDOW_WIDTH - 1)) << map->WindowShift);
+			span->LineStride = 1;
+		} else {
+			span->Line = map->Indices + pos_x;
+			span->LineStride = map->Pitch;
+		}
+		span->Ring = 0;
+	}
+
+	span->LineDefs = map->Defs;
+	if (line_fill != NULL) {
+		span->LineDefs = line_fill;
+		span->Line = &FillIndex;
+		span->LineStride = 0;
+	}
+
+	span->Left = length;
+}
+
+u16 MAP_nextSegment(struct MAP_Span *span)
+{
+	if (span->Left == 0)
+		return 0;
+
+	MAP_Pos pos = span->Pos;
+	if (span->Wraps)
+		pos = wrapPos(pos, span->Size);
+
+	u16 length;
+
+	if (pos < 0) {
+		length = COM_min((u16)-pos, span->Left);
+
+		span->Defs = span->FillBefore;
+		span->Indices = &FillIndex;
+		span->Stride = 0;
+	} else if (pos >= span->Size) {
+		length = span->Left;
+
+		span->Defs = span->FillAfter;
+		span->Indices = &FillIndex;
+		span->Stride = 0;
+	} else {
+		length = COM_min((u16)(span->Size - pos), span->Left);
+
+		if (span->Ring != 0) {
+			// Rows of streamed maps start over at the end of the ring of columns.
+			pos &= span->Ring - 1;
+			length = COM_min(length, (u16)(span->Ring - pos));
+		}
+
+		span->Defs = span->LineDefs;
+		span->Indices = span->Line + (s32)pos * span->LineStride;
+		span->Stride = span->LineStride;
+	}
+
+	span->Pos += length;
+	span->Left -= length;
+
+	return length;
+}
+
+bool MAP_initCollisions(struct MAP_Map *map)
+{
+	if (map->Collisions != NULL)
+		return FALSE;
+
+	u8 shift = 0;
+	while (((u32)1 << shift) * 4 < (u32)map->SizeX)
+		shift++;
+
+	// Offsets into the grid are 16-bit, which is also the most that can be allocated at once.
+	u32 size = (u32)map->SizeY << shift;
+	if (size > 0xFFFF)
+		return TRUE;
+
+	u8 *it = HeapAllocPtr(size);
+	if (it == NULL)
+		return TRUE;
+
+	map->Collisions = it;
+	map->CollisionShift = shift;
+
+	// Streamed maps are built from the whole level in the file rather than just the window.
+	const MAP_TileIndex *indices = map->Window != NULL ? map->Source : map->Indices;
+
+	for (MAP_Pos row = 0; row < map->SizeY; row++) {
+		const MAP_TileIndex *index = indices + (s32)row * map->Pitch;
+		u8 *byte = it + ((u16)row << shift);
+
+		for (MAP_Pos col = 0; col < map->SizeX; col += 4) {
+			u8 packed = 0;
+			for (u8 i = 0; i < 4; i++) {
+				packed <<= 2;
+				if (col + i < map->SizeX)
+					packed |= map->Defs[*index++].Collision;
+			}
+
+			*byte++ = packed;
+		}
+	}
+
+	return FALSE;
+}
+
+void MAP_deInitCollisions(struct MAP_Map *map)
+{
+	if (map->Collisions == NULL)
+		return;
+
+	HeapFreePtr(map->Collisions);
+
+	map->Collisions = NULL;
+	map->CollisionShift = 0;
+}
+
+enum MAP_Collision MAP_getCollision(const struct MAP_Map *map, MAP_Pos pos_x, MAP_Pos pos_y)
+{
+	// Comparing as unsigned checks both sides of the map at once.
+	if (map->Collisions != NULL && (u16)pos_x < (u16)map->SizeX &&
+			(u16)pos_y < (u16)map->SizeY) {
+		u8 byte = map->Collisions[((u16)pos_y << map->CollisionShift) + ((u16)pos_x >> 2)];
+		return (byte >> ((~pos_x & 3) << 1)) & 3;
+	}
+
+	return MAP_getTile(map, pos_x, pos_y)->Collision;
+}
+
+u16 MAP_findCollision(const struct MAP_Map *map, MAP_Pos pos_x, MAP_Pos pos_y, u16 length,
+		enum MAP_SpanDir dir, enum MAP_Collision collision)
+{
+	// Every two bits of `pattern` are `collision`, so a tile with it is two zero bits in
+	// `byte ^ pattern`.
+	u8 pattern = collision * 0x55;
+	bool in_row = dir == MAP_SpanDir_RIGHT && map->Collisions != NULL &&
+			(u16)pos_y < (u16)map->SizeY;
+
+	for (u16 i = 0; i < length;) {
+		MAP_Pos tile_x = dir == MAP_SpanDir_RIGHT ? pos_x + i : pos_x;
+		MAP_Pos tile_y = dir == MAP_SpanDir_DOWN ? pos_y + i : pos_y;
+
+		// Whole bytes of the row are skipped at once if none of their tiles match.
+		if (in_row && (tile_x & 3) == 0 && length - i >= 4 && tile_x >= 0 &&
+				tile_x + 4 <= map->SizeX) {
+			u8 diff = map->Collisions[((u16)tile_y << map->CollisionShift) +
+					((u16)tile_x >> 2)] ^ pattern;
+
+			if ((~(diff | diff >> 1) & 0x55) == 0) {
+				i += 4;
+				continue;
+			}
+		}
+
+		if (MAP_getCollision(map, tile_x, tile_y) == collision)
+			return i;
+		i++;
+	}
+
+	return length;
 }
@@ -6,6 +6,8 @@
 
 #include "common.h"
 
+#include "sll.h"
+
 // MAP Namespace: Everything related to the static map, specifically tiles and specials.
 /*
 	Super Grayland has a great tile system. It allows for two sprites to be layered on top of
@@ -81,7 +83,12 @@ struct MAP_TileDef
 	// The extra physics/property of the tile.
 	u8 Property: 3;  /* enum MAP_Property */
 
-	u8 : 3; // Extra space
+	// Whether the back/front sprite is drawn in front of objects. A foreground back sprite
+	// hides objects behind the whole tile.
+	bool IsBackFg: 1;
+	bool IsFrontFg: 1;
+
+	u8 : 1; // Extra space
 };
 
 // An index into one of the 255 tile definitions.
@@ -95,18 +102,136 @@ enum MAP_Wrap
 	MAP_Wrap_LEVEL // The entire level scrolls continuously. There are no visible edges.
 };
 
+// Flags in a map object.
+enum MAP_ObjFlag
+{
+	MAP_ObjFlag_FLIP_X = 1 << 0, // Sets `FlipAcrossX` of the object
+	MAP_ObjFlag_FLIP_Y = 1 << 1, // Sets `FlipAcrossY` of the object
+	MAP_ObjFlag_FREE3  = 1 << 2  // Sets `Free3` of the object
+};
+
+// An object as stored in a map file, which is made into an `OBJ_Object` when the level starts.
+// This struct should be kept small since levels can have a great many objects.
+struct MAP_Obj
+{
+	// 8 bytes
+
+	// Tile position of the object, in big endian
+	MAP_Pos PosX;
+	MAP_Pos PosY;
+
+	u8 Type; /* enum OBJ_Type */
+
+	// Initial values of the object's auxillary variables
+	u8 Free1;
+	u8 Free2;
+	u8 Flags; /* enum MAP_ObjFlag */
+};
+
+// The editor keeps map objects in a list sorted by their X position.
+SLL_DECLARE(MAP_Obj);
+
+// Map files:
+/*
+	Maps are stored in `sglm` files, which are read in place with `HeapDeref` like sprite
+	banks. Every section starts at an even offset and the tile definitions are laid out just
+	like `MAP_TileDef`, so `Defs` and `Indices` point straight into the file on the calculator
+	and loading a level takes no time and no memory no matter how large it is. All numbers are
+	big endian, and the file consists of:
+	* A `MAP_FileHeader`.
+	* `NumDefs` `MAP_TileDef`s. Each is the big endian `Back` and `Front`, `Special`, and then a
+	  byte of `Collision << 6 | Property << 3 | IsBackFg << 2 | IsFrontFg << 1`, which is how
+	  GCC lays out the bitfields on the 68k. Little endian hosts unpack a copy of these.
+	* `SizeX * SizeY` `MAP_TileIndex`s in rows, plus a zero if there are an odd number.
+	* The `MAP_Obj` for the player followed by `NumObjs` `MAP_Obj`s sorted by X position.
+	* `NumSpecials` specials of `MAP_SPECIAL_SIZE` bytes each.
+	* `NameLength` characters of the level name, plus a zero if there are an odd number.
+	* `TextSize` bytes of text for the specials.
+	The indices aren't checked against `NumDefs` when loading since that would mean reading
+	every tile, so a corrupt file can show garbage tiles, but can't do anything worse.
+*/
+
+// The version of map files that this version of SGL reads
+#define MAP_FILE_VERSION 1
+
+// Size of a special in a map file. Specials aren't implemented yet, so they are kept as they are.
+#define MAP_SPECIAL_SIZE 16
+
+// Flags in a map file header.
+enum MAP_FileFlag
+{
+	MAP_FileFlag_RAIN = 1 << 0 // The level has rain falling in it.
+};
+
+// The header at the start of a map file.
+struct MAP_FileHeader
+{
+	char Magic[4]; // Always "SGLM"
+	u16 Version;   // MAP_FILE_VERSION
+	u16 SizeX;
+	u16 SizeY;
+	u16 NumDefs;
+	u16 NumObjs;   // Not counting the player
+	u16 NumSpecials;
+	u16 TextSize;
+	u8 NameLength;
+	u8 Act;
+	u8 Music;
+	u8 Flags;      // enum MAP_FileFlag
+	u8 WrapX;      // enum MAP_Wrap
+	u8 WrapY;
+};
+
 struct MAP_Map
 {
+	// The open map file, or H_NULL for the built-in map
+	FILES File;
+
 	// Array of tile definitions that is indexed into with `Indices`.
 	struct MAP_TileDef *Defs;
+	// Number of tile definitions in `Defs`.
+	u16 NumDefs;
+	// On little endian hosts, the copy of the file's definitions that `Defs` points to, or NULL
+	// if there is none. Always NULL on the calculator.
+	struct MAP_TileDef *HostDefs;
 
 	// Two-dimensional array of indices indexing into `Defs`. It is stored in rows from the top
 	// left of the map, i.e. `map->Indices[map->SizeX]` is one tile below the top left tile.
+	// When it points into the map file, which may be archived, it must not be written to.
 	MAP_TileIndex *Indices;
+	// TRUE if the level's own indices are in the map file, so its tiles can only be changed
+	// once the map is guarded or streamed, which copy them out of it.
+	bool ReadOnly;
 
 	// The dimensions of the map in tiles.
 	MAP_Pos SizeX;
 	MAP_Pos SizeY;
+	// Number of indices from one row of `Indices` to the next, which is `SizeX` unless the map
+	// is guarded. For streamed maps, it is the same for `Source`.
+	MAP_Pos Pitch;
+
+	// For guarded maps, a pointer to each row of `Indices`, including the rows of the guard
+	// border, so `Rows[-MAP_GUARD]` is the top row. NULL if the map isn't guarded. See
+	// `MAP_initGuard`.
+	MAP_TileIndex **Rows;
+	// `Defs` and `Indices` from before the map was guarded
+	struct MAP_TileDef *PlainDefs;
+	MAP_TileIndex *PlainIndices;
+
+	// For streamed maps, the ring of columns paged in from `Source`, and the first column in
+	// it. NULL if the map isn't streamed. See `MAP_initStream`.
+	MAP_TileIndex *Window;
+	MAP_Pos WindowX;
+	// Each column takes up `1 << WindowShift` indices in `Window`.
+	u8 WindowShift;
+	// The indices that streamed maps are paged in from, usually inside the level file
+	const MAP_TileIndex *Source;
+
+	// Packed grid of the collision of every tile in the map. NULL if there is none. See
+	// `MAP_initCollisions`.
+	u8 *Collisions;
+	// Rows of `Collisions` are `1 << CollisionShift` bytes apart.
+	u8 CollisionShift;
 
 	// The currently scrolled position of the map in pixels.
 	MAP_Scroll ScrollX;
@@ -115,15 +240,114 @@ struct MAP_Map
 	// If and how to wrap the level.
 	enum MAP_Wrap WrapX;
 	enum MAP_Wrap WrapY;
+	// The rest of the level from the map file, which are all NULL or zero for the built-in map.
+	// The objects are left in the file as they are, so their positions are big endian.
+	const struct MAP_Obj *Player;
+	const struct MAP_Obj *Objs;
+	u16 NumObjs;
+	const u8 *Specials;
+	u16 NumSpecials;
+	const char *Text;
+	u16 TextSize;
+
+	// Name of the level, which isn't null terminated
+	const char *Name;
+	u8 NameLength;
+	u8 Act;
+	u8 Music;
+	bool UseRain;
 };
 
 // TODO: Const-ify all functions taking a struct, ensure void function(void) functions
-// Initializes the map.
-void MAP_init(struct MAP_Map *map);
-// Deinitializes the map.
+// Initializes the map from the map file `name`, or from the built-in map if there is no such
+// file. Throws an error if the file is invalid or outdated.
+void MAP_init(struct MAP_Map *map, const char *name);
+// Deinitializes the map, including the guard border, window, and collision grid.
 void MAP_deInit(struct MAP_Map *map);
 
+// Width in tiles of the guard border around guarded maps. Anything that checks tiles around an
+// object, which is at most two tiles wide, stays well within this.
+#define MAP_GUARD 4
+
+/* Guard border storage
+	Looking tiles up is the hot path of both collision and drawing, and most of the work
+	`MAP_getTile` does is checking whether the position is off the map to return one of the
+	tiles for off the map. A guarded map surrounds the map with a border `MAP_GUARD` tiles wide
+	of those tiles instead, so that looking up anything near the map is just a load from a
+	table of rows and an add.
+
+	The border uses three definitions after the level's own: a solid tile for the sides, air
+	for the top, and death air for the bottom. So, a guarded map has a copy of `Defs` with these
+	added and a copy of `Indices` with the border around it, where `Pitch` is the width of the
+	whole thing and `Indices` points to the top left tile inside the border. `NumDefs` stays
+	the same, so the border tiles are not level tiles, just like the tiles off the map from
+	`MAP_getTile` in unguarded maps.
+*/
+
+// Copies the map into guarded storage. Returns TRUE if the map can't be guarded, which means
+// that it wraps, is streamed, has more than 253 definitions, or there isn't enough memory, in
+// which case it's left as it was. Since the copy is made once, this must be done before tiles change.
+bool MAP_initGuard(struct MAP_Map *map);
+// Frees the guarded storage, putting back the map it was made from. Changes to the tiles of
+// the guarded map are lost. It is safe to call this on maps that aren't guarded.
+void MAP_deInitGuard(struct MAP_Map *map);
+
+// Number of columns in the window of streamed maps. It must be a power of two.
+#define MAP_WINDOW_WIDTH 64
+// Number of columns to either side of the view that are always in the window, so that objects
+// just off the screen have tiles to collide with.
+#define MAP_WINDOW_MARGIN 8
+
+/* Streamed maps
+	A level file is read in place, but `Indices` can't point into it once the file is larger
+	than the memory left for the level or the level needs to change its tiles, since archived
+	files can't be written to. A streamed map leaves the level in the file and keeps only a
+	window of `MAP_WINDOW_WIDTH` columns around the camera in memory, which is paged in from
+	`Source` as the camera moves with `MAP_pageWindow`.
+
+	The window is a ring of columns, where column x of the map is stored in column
+	`x & (MAP_WINDOW_WIDTH - 1)` of the ring, so moving the window only copies the columns that
+	weren't in it before. Columns are padded to a power of two so that finding one is a shift.
+	Tiles in columns outside the window read as solid, so objects far from the camera must not
+	depend on them.
+
+	Maps that wrap horizontally or are guarded can't be streamed, and there is no point in
+	streaming a map that isn't wider than the window.
+*/
+
+// Starts streaming the map from its current `Indices`, which becomes `Source` and isn't
+// written to, and pages in the columns at the left of the map. Returns TRUE if the map can't
+// be streamed or there isn't enough memory, in which case it's left as it was.
+bool MAP_initStream(struct MAP_Map *map);
+// Frees the window, putting `Source` back as `Indices`. Changes to the tiles in the window are
+// lost. It is safe to call this on maps that aren't streamed.
+void MAP_deInitStream(struct MAP_Map *map);
+// Maps whose guarded copy would take up more than 1 / MAP_GUARD_SHARE of the free memory are
+// streamed by `MAP_initStorage` instead, leaving the rest for everything else.
+#define MAP_GUARD_SHARE 2
+
+// Gives the map storage whose tiles can change: a guarded copy for maps that fit in memory
+// well, and a window for bigger ones, so even levels larger than the free memory can be
+// played. If that fails, the other is tried. Returns TRUE if neither works, in which case the
+// map is left as it was.
+bool MAP_initStorage(struct MAP_Map *map);
+// Pages columns into the window of a streamed map so that the `view_width` columns from
+// `view_x` and the margin around them are all in it. Does nothing if they already are, which
+// is almost always, or if the map isn't streamed.
+void MAP_pageWindow(struct MAP_Map *map, MAP_Pos view_x, MAP_Pos view_width);
+
+// Returns where the index of a tile inside the map is stored. In streamed maps, the tile must
+// be in the window. Tiles should be changed with `MAP_setTile` instead of through this.
+MAP_TileIndex *MAP_getIndex(struct MAP_Map *map, MAP_Pos pos_x, MAP_Pos pos_y);
+// Changes a tile inside the map to the definition `index`, keeping the collision grid up to
+// date. In streamed maps, the tile must be in the window, and the change is lost once it
+// leaves. Returns TRUE if the tile can't be changed because the map is `ReadOnly` and neither
+// guarded nor streamed.
+bool MAP_setTile(struct MAP_Map *map, MAP_Pos pos_x, MAP_Pos pos_y, MAP_TileIndex index);
+
 /* Get a tile definition on the map.
+	For guarded maps, positions within the guard border are read straight from it. For
+	streamed maps, columns outside the window are solid.
 	If the position is outside of the map boundaries, the behaviour varies:
 	* For non-wrapping levels, it returns a solid tile if to the left or right of the map, an
 	  air tile if above the map, and a death air tile if below the map.
@@ -132,3 +356,88 @@ void MAP_deInit(struct MAP_Map *map);
 	  not be done.
 */
 const struct MAP_TileDef *MAP_getTile(const struct MAP_Map *map, MAP_Pos pos_x, MAP_Pos pos_y);
+
+// Which way a span runs across the map.
+enum MAP_SpanDir
+{
+	MAP_SpanDir_RIGHT, // Along a row
+	MAP_SpanDir_DOWN   // Along a column
+};
+
+/* A straight run of tiles across the map for reading many tiles in a row quickly.
+	`MAP_getTile` compares and wraps both coordinates and multiplies to find the index for every
+	tile, which adds up when filling the tile buffer. A span does all of that once for each
+	segment of the run that is either inside the map or in one stretch off its edge, and then
+	each tile of the segment is a single step through `Indices`.
+
+	`MAP_nextSegment` returns how many tiles are in the next segment. The tiles of the segment
+	are `&span.Defs[*span.Indices]`, adding `Stride` to `Indices` after each one. Off the edges
+	of the map, `Indices` points to a zero and `Stride` is zero, so the same loop gives the
+	same tile as `MAP_getTile` over and over without having to check. Spans wrap any number of
+	times in wrapping levels, unlike `MAP_getTile`.
+
+	In streamed maps, spans don't check the window like `MAP_getTile` does, so they must stay
+	inside it, which the view and its margin always do.
+*/
+struct MAP_Span
+{
+	// The current segment
+	const struct MAP_TileDef *Defs;
+	const MAP_TileIndex *Indices;
+	s16 Stride;
+
+	// The same for the part of the row or column inside the map, starting at position zero
+	// along it. If the whole row or column is off the map, it repeats the tile there instead.
+	const struct MAP_TileDef *LineDefs;
+	const MAP_TileIndex *Line;
+	s16 LineStride;
+	// For rows of streamed maps, the number of columns in the ring they run through, after
+	// which `Line` starts over. Zero otherwise.
+	MAP_Pos Ring;
+	// Tiles off the start and end of the row or column in non-wrapping levels
+	const struct MAP_TileDef *FillBefore;
+	const struct MAP_TileDef *FillAfter;
+
+	// Position along the row or column of the next segment, and its length
+	MAP_Pos Pos;
+	MAP_Pos Size;
+	bool Wraps;
+
+	// Number of tiles left in the span
+	u16 Left;
+};
+
+// Starts a span of `length` tiles from (`pos_x`, `pos_y`) in the direction `dir`.
+void MAP_initSpan(struct MAP_Span *span, const struct MAP_Map *map, MAP_Pos pos_x,
+		MAP_Pos pos_y, u16 length, enum MAP_SpanDir dir);
+// Moves to the next segment of the span and returns its length, or zero if there are none left.
+u16 MAP_nextSegment(struct MAP_Span *span);
+
+/* Collision grid
+	Collision only needs to know the `MAP_Collision` of tiles, but finding it with `MAP_getTile`
+	means loading an index and then a whole tile definition for its bitfield. The collision grid
+	is a copy of just the collision of every tile in the map, packed four tiles to a byte with
+	the leftmost tile in the top two bits, like pixels on the screen. A whole map of collision
+	is a quarter of the size of its indices, so collision checks around objects mostly read
+	bytes that were just read, and four tiles can be checked for a collision at once.
+
+	Rows of the grid are padded to a power of two bytes so that finding one is a shift. The
+	grid covers the whole map even when it is streamed, so objects outside the window collide
+	with the real level instead of solid tiles. `MAP_setTile` keeps it up to date, and paging a
+	column into the window of a streamed map puts the column's collision back as well.
+*/
+
+// Builds the collision grid of the map. Returns TRUE if there isn't enough memory, in which
+// case the collision functions read the tiles instead.
+bool MAP_initCollisions(struct MAP_Map *map);
+// Frees the collision grid. It is safe to call this on maps that don't have one.
+void MAP_deInitCollisions(struct MAP_Map *map);
+
+// Returns the collision of a tile, which is the same as the `Collision` of `MAP_getTile`
+// except in streamed maps, where columns outside the window have their real collision.
+enum MAP_Collision MAP_getCollision(const struct MAP_Map *map, MAP_Pos pos_x, MAP_Pos pos_y);
+// Returns the number of tiles from (`pos_x`, `pos_y`) in the direction `dir` before the first
+// one that has the collision `collision`, or `length` if none of the `length` tiles do. Rows
+// inside the map are checked four tiles at a time.
+u16 MAP_findCollision(const struct MAP_Map *map, MAP_Pos pos_x, MAP_Pos pos_y, u16 length,
+		enum MAP_SpanDir dir, enum MAP_Collision collision);
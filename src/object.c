@@ -3,3 +3,409 @@
 // Before delving into the code, please read `readme_source.txt` to understand the basic design.
 
 #include "object.h"
+
+// Temporary definitions to go with the temporary object sprites in `screen.c`
+const struct OBJ_ObjectDef OBJECT_DEFS[OBJ_Type_LEN] = {
+	[OBJ_Type_GRAYFORD] = {
+		.RectX = 1,
+		.RectWidth = 6,
+		.RectHeight = 15,
+		.Sprite = 2,
+		.ExtraHeight = 1
+	},
+	[OBJ_Type_SUPER_GRAYFORD] = {
+		.RectX = 1,
+		.RectWidth = 14,
+		.RectHeight = 15,
+		.Sprite = 6,
+		.ExtraWidth = 1,
+		.ExtraHeight = 1
+	},
+	[OBJ_Type_TESTER] = {
+		.RectWidth = 8,
+		.RectHeight = 8,
+		.Sprite = 0
+	}
+};
+
+SLL_DEFINE(OBJ_Object, OBJ_getColumn)
+
+void OBJ_initFromMap(struct OBJ_Object *obj, const struct MAP_Obj *map_obj)
+{
+	COM_zero(obj);
+
+	obj->PosX = FXD_convert(MAP_Pos, OBJ_Pos, (MAP_Pos)COM_be16(map_obj->PosX));
+	obj->PosY = FXD_convert(MAP_Pos, OBJ_Pos, (MAP_Pos)COM_be16(map_obj->PosY) + 1);
+
+	obj->Type = map_obj->Type;
+	obj->Free1 = map_obj->Free1;
+	obj->Free2 = map_obj->Free2;
+	obj->Free3 = (map_obj->Flags & MAP_ObjFlag_FREE3) != 0;
+	obj->FlipAcrossX = (map_obj->Flags & MAP_ObjFlag_FLIP_X) != 0;
+	obj->FlipAcrossY = (map_obj->Flags & MAP_ObjFlag_FLIP_Y) != 0;
+
+	const struct OBJ_ObjectDef *def = OBJ_getDef(obj->Type);
+	if (def->Construct != NULL)
+		def->Construct(obj);
+}
+
+void OBJ_init(struct OBJ_Objects *objs, u16 cap, u16 max_active)
+{
+	struct OBJ_Active *active = &objs->Active;
+
+	SLL_OBJ_Object_init(&objs->List, cap);
+
+	// All of the arrays share one allocation, from the widest type to the narrowest.
+	active->PosX = HeapAllocPtr((u32)max_active * (2 * sizeof(OBJ_Pos) + 2 * sizeof(OBJ_Vel) +
+			sizeof(MAP_Pos) + sizeof(u16)) + (u32)cap * sizeof(u16));
+	if (active->PosX == NULL)
+		COM_throwErr(COM_Error_MEMORY, "active objects");
+
+	active->PosY = active->PosX + max_active;
+	active->VelX = (OBJ_Vel *)(active->PosY + max_active);
+	active->VelY = active->VelX + max_active;
+	active->Columns = (MAP_Pos *)(active->VelY + max_active);
+	active->Indices = (u16 *)(active->Columns + max_active);
+	active->Slots = active->Indices + max_active;
+
+	// SLL_NULL is all ones in every byte.
+	memset(active->Slots, 0xFF, cap * sizeof(u16));
+
+	active->Len = 0;
+	active->Cap = max_active;
+
+	// An empty range, so the first one set is always new
+	active->Left = 0;
+	active->Right = -1;
+}
+
+void OBJ_deInit(struct OBJ_Objects *objs)
+{
+	if (objs->Active.PosX != NULL)
+		HeapFreePtr(objs->Active.PosX);
+	SLL_OBJ_Object_deInit(&objs->List);
+
+	COM_zero(objs);
+}
+
+// Moves the position and velocity of the object `index` into the active arrays.
+static void activate(struct OBJ_Objects *objs, u16 index)
+{
+	struct OBJ_Active *active = &objs->Active;
+	const struct OBJ_Object *obj = &objs->List.Items[index];
+	u16 slot = active->Len++;
+
+	active->PosX[slot] = obj->PosX;
+	active->PosY[slot] = obj->PosY;
+	active->VelX[slot] = obj->VelX;
+	active->VelY[slot] = obj->VelY;
+	active->Columns[slot] = OBJ_getColumn(obj);
+	active->Indices[slot] = index;
+	active->Slots[index] = slot;
+}
+
+// Moves the position and velocity of the active object in `slot` back into the object. The
+// last slot is moved into the hole.
+static void deactivate(struct OBJ_Objects *objs, u16 slot)
+{
+	struct OBJ_Active *active = &objs->Active;
+	u16 index = active->Indices[slot];
+	struct OBJ_Object *obj = &objs->List.Items[index];
+
+	// The column of `PosX` is already the same, so the object stays in place in the list.
+	obj->PosX = active->PosX[slot];
+	obj->PosY = active->PosY[slot];
+	obj->VelX = active->VelX[slot];
+	obj->VelY = active->VelY[slot];
+	active->Slots[index] = SLL_NULL;
+
+	u16 last = --active->Len;
+	if (slot != last) {
+		active->PosX[slot] = active->PosX[last];
+		active->PosY[slot] = active->PosY[last];
+		active->VelX[slot] = active->VelX[last];
+		active->VelY[slot] = active->VelY[last];
+		active->Columns[slot] = active->Columns[last];
+		active->Indices[slot] = active->Indices[last];
+		active->Slots[active->Indices[slot]] = slot;
+	}
+}
+
+// Sorts the active object in `slot`, which has moved into `column`, back into place in the
+// list, and makes it inactive if the column is out of range.
+static void changeColumn(struct OBJ_Objects *objs, u16 slot, MAP_Pos column)
+{
+	struct OBJ_Active *active = &objs->Active;
+	u16 index = active->Indices[slot];
+
+	active->Columns[slot] = column;
+	objs->List.Items[index].PosX = active->PosX[slot];
+	SLL_OBJ_Object_sort(&objs->List, index);
+
+	if (column < active->Left || column > active->Right)
+		deactivate(objs, slot);
+}
+
+void OBJ_setActiveRange(struct OBJ_Objects *objs, MAP_Pos left, MAP_Pos right)
+{
+	struct OBJ_Active *active = &objs->Active;
+	const SLL_List(OBJ_Object) *list = &objs->List;
+
+	if (left == active->Left && right == active->Right)
+		return;
+
+	active->Left = left;
+	active->Right = right;
+
+	// The objects in range are found by walking from an active object, if any, since it was in
+	// the last range, which is usually right next to this one. It stays in the list after it's
+	// made inactive, so it's picked first.
+	u16 index = active->Len != 0 ? active->Indices[0] : list->Base.First;
+
+	// Going backwards, the slots moved into holes have already been looked at.
+	for (u16 slot = active->Len; slot-- != 0;) {
+		if (active->Columns[slot] < left || active->Columns[slot] > right)
+			deactivate(objs, slot);
+	}
+
+	const struct SLL_Links *links = list->Base.Links;
+
+	u16 prev;
+	while (index != SLL_NULL && (prev = links[index].Left) != SLL_NULL &&
+			OBJ_getColumn(&list->Items[prev]) >= left)
+		index = prev;
+	while (index != SLL_NULL && OBJ_getColumn(&list->Items[index]) < left)
+		index = links[index].Right;
+
+	for (; index != SLL_NULL && OBJ_getColumn(&list->Items[index]) <= right &&
+			active->Len < active->Cap; index = links[index].Right) {
+		if (active->Slots[index] == SLL_NULL)
+			activate(objs, index);
+	}
+}
+
+void OBJ_moveActive(struct OBJ_Objects *objs)
+{
+	struct OBJ_Active *active = &objs->Active;
+
+	// Each axis is its own loop over two arrays walked with pointers, which the 68k can do with
+	// post-increment addressing and computers can vectorize.
+	OBJ_Pos *pos = active->PosX;
+	const OBJ_Vel *vel = active->VelX;
+	for (u16 i = active->Len; i != 0; i--)
+		*pos++ += *vel++;
+
+	pos = active->PosY;
+	vel = active->VelY;
+	for (u16 i = active->Len; i != 0; i--)
+		*pos++ += *vel++;
+
+	// Objects are sorted one at a time while the rest are still in their old columns, so the
+	// list is always sorted apart from the object being moved. Going backwards, the slots moved
+	// into holes by objects leaving the range have already been looked at.
+	for (u16 slot = active->Len; slot-- != 0;) {
+		MAP_Pos column = FXD_convert(OBJ_Pos, MAP_Pos, active->PosX[slot]);
+		if (column != active->Columns[slot])
+			changeColumn(objs, slot, column);
+	}
+}
+
+void OBJ_get(const struct OBJ_Objects *objs, u16 index, struct OBJ_Object *obj)
+{
+	*obj = objs->List.Items[index];
+
+	u16 slot = objs->Active.Slots[index];
+	if (slot != SLL_NULL) {
+		obj->PosX = objs->Active.PosX[slot];
+		obj->PosY = objs->Active.PosY[slot];
+		obj->VelX = objs->Active.VelX[slot];
+		obj->VelY = objs->Active.VelY[slot];
+	}
+}
+
+void OBJ_addPosX(struct OBJ_Objects *objs, u16 index, OBJ_Pos dist)
+{
+	OBJ_setPosX(objs, index, OBJ_getPosX(objs, index) + dist);
+}
+
+void OBJ_setPosX(struct OBJ_Objects *objs, u16 index, OBJ_Pos pos)
+{
+	struct OBJ_Active *active = &objs->Active;
+	u16 slot = active->Slots[index];
+
+	if (slot == SLL_NULL) {
+		objs->List.Items[index].PosX = pos;
+		SLL_OBJ_Object_sort(&objs->List, index);
+		return;
+	}
+
+	active->PosX[slot] = pos;
+
+	MAP_Pos column = FXD_convert(OBJ_Pos, MAP_Pos, pos);
+	if (column != active->Columns[slot])
+		changeColumn(objs, slot, column);
+}
+
+// Edges of an object's collision box relative to its position. They are the positions of its
+// edge pixels rather than the edges of the box, so they can be floored to the tiles they're in.
+struct Box
+{
+	OBJ_Vel Left;
+	OBJ_Vel Right;
+	OBJ_Vel Top;
+	OBJ_Vel Bottom;
+};
+
+// Returns the collision of the tile at a point relative to the object's position.
+static enum MAP_Collision pointCollision(const struct OBJ_Object *obj,
+		const struct MAP_Map *map, OBJ_Vel x_off, OBJ_Vel y_off)
+{
+	return MAP_getCollision(map, FXD_convert(OBJ_Pos, MAP_Pos, obj->PosX + x_off),
+			FXD_convert(OBJ_Pos, MAP_Pos, obj->PosY + y_off));
+}
+
+// Returns TRUE if the top corners of the box at `y_off` are in a solid tile.
+static bool isCeiling(const struct OBJ_Object *obj, const struct MAP_Map *map,
+		const struct Box *box, OBJ_Vel y_off)
+{
+	return pointCollision(obj, map, box->Left, y_off) == MAP_Collision_SOLID ||
+			pointCollision(obj, map, box->Right, y_off) == MAP_Collision_SOLID;
+}
+
+// Returns TRUE if the bottom corners of the box at `y_off` are in a solid tile, or in a cloud
+// tile that the bottom of the box was above before it moved, since objects only land on clouds
+// from above.
+static bool isFloor(const struct OBJ_Object *obj, const struct MAP_Map *map,
+		const struct Box *box, OBJ_Vel y_off)
+{
+	enum MAP_Collision hit = COM_max(pointCollision(obj, map, box->Left, y_off),
+			pointCollision(obj, map, box->Right, y_off));
+
+	return hit == MAP_Collision_SOLID || (hit == MAP_Collision_CLOUD &&
+			FXD_floor(OBJ_Pos, obj->PosY + box->Bottom) >
+			FXD_floor(OBJ_Pos, obj->PosY + box->Bottom - obj->VelY));
+}
+
+// Pushes the object `index` out of the wall it is moving into so that the side of its box is
+// right against the wall, and stops it horizontally. `obj` is its copy, which is kept the same.
+static void pushOutOfWall(struct OBJ_Objects *objs, u16 index, struct OBJ_Object *obj,
+		const struct Box *box)
+{
+	if (obj->VelX < 0)
+		obj->PosX = FXD_ceil(OBJ_Pos, obj->PosX + box->Left + 1) - box->Left;
+	else
+		obj->PosX = FXD_floor(OBJ_Pos, obj->PosX + box->Right) - box->Right - 1;
+	obj->VelX = 0;
+
+	OBJ_setPosX(objs, index, obj->PosX);
+	*OBJ_velX(objs, index) = 0;
+}
+
+enum OBJ_Hit OBJ_tileCollision(struct OBJ_Objects *objs, u16 index, const struct MAP_Map *map)
+{
+	// If struggling to understand the code, try using an image editor and move a sprite around
+	// with pixels representing corners or the object position. Also, mind the fixed point
+	// types!
+
+	// The position and velocity might be in the active arrays, so they are read from a copy of
+	// the object. It is pushed out along with the object itself.
+	struct OBJ_Object obj_copy;
+	struct OBJ_Object *obj = &obj_copy;
+	OBJ_get(objs, index, obj);
+	const struct OBJ_ObjectDef *def = OBJ_getDef(obj->Type);
+
+	// The box is measured from the bottom left of the sprite, so it must be flipped with it.
+	SCR_Pixel rect_x = def->RectX;
+	SCR_Pixel rect_y = def->RectY;
+
+	if (obj->FlipAcrossX)
+		rect_x = (def->ExtraWidth + 1) * SCR_SPRITE_SIZE - rect_x - def->RectWidth;
+	if (obj->FlipAcrossY)
+		rect_y = (def->ExtraHeight + 1) * SCR_SPRITE_SIZE - rect_y - def->RectHeight;
+
+	// The right and bottom edges are one less than the box's size from the others so that they
+	// are inside the box when floored to a tile.
+	struct Box box;
+	box.Left = FXD_convert(SCR_Pixel, OBJ_Vel, rect_x);
+	box.Right = box.Left + FXD_convert(SCR_Pixel, OBJ_Vel, def->RectWidth) - 1;
+	box.Bottom = -FXD_convert(SCR_Pixel, OBJ_Vel, rect_y) - 1;
+	box.Top = box.Bottom - FXD_convert(SCR_Pixel, OBJ_Vel, def->RectHeight) + 1;
+
+	OBJ_Vel height = box.Bottom - box.Top;
+	OBJ_Vel one_tile = FXD_literalInt(OBJ_Vel, 1);
+
+	// TRUE if the box is taller than one tile from the bottom of the object
+	bool is_tall = rect_y + def->RectHeight > SCR_SPRITE_SIZE;
+
+	enum OBJ_Hit dir = OBJ_Hit_NONE;
+
+	// Check walls only if the object is moving towards them.
+	if (obj->VelX != 0) {
+		OBJ_Vel side = obj->VelX > 0 ? box.Right : box.Left;
+		enum OBJ_Hit side_hit = obj->VelX > 0 ? OBJ_Hit_RIGHT : OBJ_Hit_LEFT;
+
+		bool hit;
+
+		if (obj->VelY == 0) {
+			// Moving straight sideways only needs the top, bottom, and, if tall, one tile
+			// above the bottom.
+			hit = pointCollision(obj, map, side, box.Top) == MAP_Collision_SOLID ||
+					pointCollision(obj, map, side, box.Bottom) == MAP_Collision_SOLID ||
+					(is_tall && pointCollision(obj, map, side, box.Bottom - one_tile) ==
+							MAP_Collision_SOLID);
+		} else if (obj->VelY > 0) {
+			/* Moving down:
+				* The point checked near the bottom moves up by the vertical velocity so that
+				  going into the floor doesn't count as hitting a wall, but going into a wall
+				  does. Even if this puts it above the box, it is still checked so that _some_
+				  wall collision is found.
+				* The top is checked unless the velocity is more than the height, in which
+				  case the top could register a false collision.
+				* If tall, one tile above the bottom is always above the floor.
+			*/
+			hit = pointCollision(obj, map, side, box.Bottom - obj->VelY) ==
+							MAP_Collision_SOLID ||
+					(is_tall && pointCollision(obj, map, side, box.Bottom - one_tile) ==
+							MAP_Collision_SOLID);
+
+			if (obj->VelY < height)
+				hit = hit || pointCollision(obj, map, side, box.Top) == MAP_Collision_SOLID;
+		} else {
+			// Moving up is the same as moving down, but reversed.
+			hit = pointCollision(obj, map, side, box.Top - obj->VelY) ==
+							MAP_Collision_SOLID ||
+					(is_tall && pointCollision(obj, map, side, box.Top + one_tile) ==
+							MAP_Collision_SOLID);
+
+			if (-obj->VelY < height)
+				hit = hit || pointCollision(obj, map, side, box.Bottom) == MAP_Collision_SOLID;
+		}
+
+		if (hit) {
+			pushOutOfWall(objs, index, obj, &box);
+			dir |= side_hit;
+		}
+	}
+
+	// Tall objects can move sideways into a gap one tile high, so push them back out of it.
+	if (is_tall && ((isFloor(obj, map, &box, box.Bottom) &&
+			isCeiling(obj, map, &box, box.Bottom - one_tile * 2)) ||
+			(isFloor(obj, map, &box, box.Top + one_tile * 2) &&
+			isCeiling(obj, map, &box, box.Top))))
+		pushOutOfWall(objs, index, obj, &box);
+
+	// Floors and ceilings push out just like walls.
+	if (obj->VelY > 0 && isFloor(obj, map, &box, box.Bottom)) {
+		OBJ_setPosY(objs, index, FXD_floor(OBJ_Pos, obj->PosY + box.Bottom) - box.Bottom - 1);
+		*OBJ_velY(objs, index) = 0;
+
+		dir |= OBJ_Hit_BOTTOM;
+	} else if (obj->VelY < 0 && isCeiling(obj, map, &box, box.Top)) {
+		OBJ_setPosY(objs, index, FXD_ceil(OBJ_Pos, obj->PosY + box.Top + 1) - box.Top);
+		*OBJ_velY(objs, index) = 0;
+
+		dir |= OBJ_Hit_TOP;
+	}
+
+	return dir;
+}
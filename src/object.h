@@ -8,6 +8,7 @@
 
 #include "map.h"
 #include "screen.h"
+#include "sll.h"
 
 // OBJ Namespace: Dynamic object management
 /*
@@ -53,12 +54,14 @@ struct OBJ_Object
 	// 16 bytes
 
 	// Current position of the object. NEVER change the position without using `OBJ_addPosX/Y`
-	// or `OBJ_setPosX/Y`; that would break object linked list sorting.
+	// or `OBJ_setPosX/Y`; that would break object linked list sorting. While the object is
+	// active, its position is kept in `OBJ_Active` instead, and only the column of `PosX` is
+	// kept up to date here.
 	OBJ_Pos PosX;
 	OBJ_Pos PosY;
 
 	// Current velocity of the object. This may not exceed eight as that would break collision
-	// detection and slow down screen scrolling.
+	// detection. Like the position, it is kept in `OBJ_Active` while the object is active.
 	OBJ_Vel VelX;
 	OBJ_Vel VelY;
 
@@ -88,6 +91,53 @@ struct OBJ_Object
 	bool FlipAcrossY;
 };
 
+// Objects are kept in a list sorted by the column of tiles their X position is in, so moving
+// within a column never needs sorting.
+SLL_DECLARE(OBJ_Object);
+
+// The column of tiles of an object's X position, which is its key in the list. This shifts
+// rather than using `FXD_convert`, since the list needs the type of its key outside functions.
+#define OBJ_getColumn(obj) ((MAP_Pos)((obj)->PosX >> (OBJ_Pos_POINT - MAP_Pos_POINT)))
+
+// The positions and velocities of the active objects, which are the objects in a range of
+// columns around the screen. While an object is active, these parallel arrays hold its
+// position and velocity instead of the object itself, so moving every active object by its
+// velocity is one tight loop over each array rather than a walk through the objects, which
+// would drag all of their other fields through memory too.
+struct OBJ_Active
+{
+	OBJ_Pos *PosX;
+	OBJ_Pos *PosY;
+	OBJ_Vel *VelX;
+	OBJ_Vel *VelY;
+
+	// The column each object is sorted by in the list. It is checked after moving so that the
+	// list is only touched for objects that moved into another column.
+	MAP_Pos *Columns;
+	// Index of each object in the list
+	u16 *Indices;
+	// Slot of each object of the list in the arrays above, or SLL_NULL if it isn't active.
+	// Unlike the others, this has room for every object in the list.
+	u16 *Slots;
+
+	// Number of active objects and how many there is room for
+	u16 Len;
+	u16 Cap;
+
+	// The range of columns that objects are active in, inclusive
+	MAP_Pos Left;
+	MAP_Pos Right;
+};
+
+// Every object of a level. Objects are added straight to the list, but they must not be
+// removed from it, since that would move the last object to another index behind the back of
+// `Slots`.
+struct OBJ_Objects
+{
+	SLL_List(OBJ_Object) List;
+	struct OBJ_Active Active;
+};
+
 enum OBJ_Hit
 {
 	OBJ_Hit_NONE   = 0,
@@ -150,8 +200,62 @@ struct OBJ_ObjectDef
 
 extern const struct OBJ_ObjectDef OBJECT_DEFS[OBJ_Type_LEN];
 
+// The widest sprite of any object def in pixels, so objects at least this far left of the
+// screen can't be on it
+#define OBJ_MAX_WIDTH (2 * SCR_SPRITE_SIZE)
+
 #define OBJ_getDef(obj_type) (&OBJECT_DEFS[obj_type])
 
+// Fills in an object from the map object it starts as, calling its constructor if it has one.
+// Its bottom left corner is at the bottom left of the map object's tile.
+void OBJ_initFromMap(struct OBJ_Object *obj, const struct MAP_Obj *map_obj);
+
+// Allocates room for `cap` objects, of which up to `max_active` can be active. No objects are
+// active until `OBJ_setActiveRange` is called. Throws an error if there isn't enough memory.
+void OBJ_init(struct OBJ_Objects *objs, u16 cap, u16 max_active);
+// Frees the objects. It is safe to call this on objects that weren't initialized.
+void OBJ_deInit(struct OBJ_Objects *objs);
+
+// Makes the objects in the columns from `left` to `right` active, and the rest inactive. If
+// the range is the same as last time, this does nothing, so an inactive object that is moved
+// into the range, or that there wasn't room for, only becomes active once the range changes.
+void OBJ_setActiveRange(struct OBJ_Objects *objs, MAP_Pos left, MAP_Pos right);
+// Moves every active object by its velocity, sorting the ones that moved into another column
+// back into place in the list and making those that left the range inactive.
+void OBJ_moveActive(struct OBJ_Objects *objs);
+
+// Pointer to the position or velocity `field` of the object `index` in `objs`, in the active
+// arrays if it is active and in the object otherwise.
+#define OBJ_field(objs, index, field)									\
+({																		\
+	u16 _index = (index);												\
+	u16 _slot = (objs)->Active.Slots[_index];							\
+	_slot != SLL_NULL ?													\
+			&(objs)->Active.field[_slot] : &(objs)->List.Items[_index].field;	\
+})
+
+// Gets the X position of the object `index` in `objs`, or pointers to its other position and
+// velocities, which can be changed freely.
+#define OBJ_getPosX(objs, index) (*OBJ_field(objs, index, PosX))
+#define OBJ_posY(objs, index) OBJ_field(objs, index, PosY)
+#define OBJ_velX(objs, index) OBJ_field(objs, index, VelX)
+#define OBJ_velY(objs, index) OBJ_field(objs, index, VelY)
+
+// Copies the object `index` in `objs` into `obj` with its current position and velocity.
+void OBJ_get(const struct OBJ_Objects *objs, u16 index, struct OBJ_Object *obj);
+
+// Moves the object `index` in `objs` or sets its position. Moving it into another column sorts
+// it back into place in the list.
+void OBJ_addPosX(struct OBJ_Objects *objs, u16 index, OBJ_Pos dist);
+void OBJ_setPosX(struct OBJ_Objects *objs, u16 index, OBJ_Pos pos);
+#define OBJ_addPosY(objs, index, dist) ((void)(*OBJ_posY(objs, index) += (dist)))
+#define OBJ_setPosY(objs, index, pos) ((void)(*OBJ_posY(objs, index) = (pos)))
+
+// Checks whether the object `index` in `objs`, which has just moved by its velocity, is inside
+// solid tiles and pushes it out of them with `OBJ_setPosX/Y` if so, stopping it in that
+// direction. Returns the sides of the object that hit something.
+enum OBJ_Hit OBJ_tileCollision(struct OBJ_Objects *objs, u16 index, const struct MAP_Map *map);
+
 // Wrap an object around the map if it is beyond the map boundaries and the level is wrappable.
 void OBJ_wrap(struct OBJ_Object *obj, const struct MAP_Map *map);
 
@@ -0,0 +1,173 @@
+// Super Grayland: Copyright 2021 Vincent Robinson under the zlib license.
+// See `license.txt` for more information.
+// Before delving into the code, please read `readme_source.txt` to understand the basic design.
+
+#include "profile.h"
+
+#include "screen.h"
+
+#ifdef PROFILE
+
+#ifdef HOST_CLOCK
+
+void PRF_initProfiler(struct PRF_Profiler *prf)
+{
+	COM_zero(prf);
+}
+
+void PRF_deInitProfiler(struct PRF_Profiler *prf)
+{
+	COM_zero(prf);
+}
+
+u32 PRF_now(void)
+{
+	return HostClock();
+}
+
+#else
+
+// The ports of the programmable rate generator. The rate bits of the control port pick how
+// many ticks of OSC2 each count takes, where zero is the fastest at 32. The counter counts up
+// and triggers auto-interrupt 5 when it overflows, going back to the value written to it.
+#define RATE_CONTROL_PORT 0x600015
+#define RATE_CONTROL_RATE_BITS 0x30
+#define RATE_COUNTER_PORT 0x600017
+
+// Number of times the counter has overflowed. This has to be a global for the interrupt.
+static volatile u16 Overflows = 0;
+
+// What the timer was set to before the profiler took it over
+static INT_HANDLER OldHandler = NULL;
+static u8 OldControl;
+static u8 OldCounter;
+
+DEFINE_INT_HANDLER(countOverflow)
+{
+	Overflows++;
+}
+
+void PRF_initProfiler(struct PRF_Profiler *prf)
+{
+	COM_zero(prf);
+
+	Overflows = 0;
+	OldControl = peekIO(RATE_CONTROL_PORT);
+	OldCounter = peekIO(RATE_COUNTER_PORT);
+	OldHandler = GetIntVec(AUTO_INT_5);
+
+	SetIntVec(AUTO_INT_5, countOverflow);
+	pokeIO(RATE_COUNTER_PORT, 0);
+	pokeIO(RATE_CONTROL_PORT, OldControl & ~RATE_CONTROL_RATE_BITS);
+}
+
+void PRF_deInitProfiler(struct PRF_Profiler *prf)
+{
+	if (OldHandler != NULL) {
+		pokeIO(RATE_CONTROL_PORT, OldControl);
+		pokeIO(RATE_COUNTER_PORT, OldCounter);
+		SetIntVec(AUTO_INT_5, OldHandler);
+		OldHandler = NULL;
+	}
+
+	COM_zero(prf);
+}
+
+u32 PRF_now(void)
+{
+	// The counter may overflow between reading it and the overflows, in which case it's read
+	// again.
+	u16 overflows;
+	u8 counter;
+	do {
+		overflows = Overflows;
+		counter = peekIO(RATE_COUNTER_PORT);
+	} while (overflows != Overflows);
+
+	return (u32)overflows << 8 | counter;
+}
+
+#endif
+
+// Largest time that fits in the HUD
+#define MAX_SHOWN 99999
+
+// Writes `num` to `it` followed by a space, returning the end of what was written.
+static char *writeNum(char *it, u32 num)
+{
+	char digits[5];
+	u16 len = 0;
+
+	num = COM_min(num, (u32)MAX_SHOWN);
+	do {
+		digits[len++] = '0' + num % 10;
+		num /= 10;
+	} while (num != 0);
+
+	while (len != 0)
+		*it++ = digits[--len];
+	*it++ = ' ';
+
+	return it;
+}
+
+void PRF_drawProfilerHud(const struct PRF_Profiler *prf)
+{
+	// Room for the phase and two sets of stats, each followed by a space, and a terminator
+	char text[2 + 2 * 3 * 6 + 1];
+	char *it = text;
+
+	const struct PRF_Stats *phase = &prf->Shown[prf->ShownPhase];
+	const struct PRF_Stats *frame = &prf->Shown[PRF_Phase_LEN];
+
+	*it++ = '0' + prf->ShownPhase;
+	*it++ = ' ';
+
+	it = writeNum(it, phase->Min);
+	it = writeNum(it, phase->Avg);
+	it = writeNum(it, phase->Max);
+	*it++ = ' ';
+
+	it = writeNum(it, frame->Min);
+	it = writeNum(it, frame->Avg);
+	it = writeNum(it, frame->Max);
+	*it = '\0';
+
+	SCR_drawHudText(text);
+}
+
+void PRF_endProfilerFrame(struct PRF_Profiler *prf)
+{
+	u32 frame_time = PRF_now() - prf->FrameStart;
+
+	for (u16 i = 0; i <= PRF_Phase_LEN; i++) {
+		u32 time = i < PRF_Phase_LEN ? prf->Times[i] : frame_time;
+		struct PRF_Stats *stats = &prf->Window[i];
+
+		if (prf->WindowFrames == 0) {
+			stats->Min = stats->Max = stats->Avg = time;
+		} else {
+			stats->Min = COM_min(stats->Min, time);
+			stats->Max = COM_max(stats->Max, time);
+			stats->Avg += time;
+		}
+
+		if (i < PRF_Phase_LEN)
+			prf->Times[i] = 0;
+	}
+
+	if (++prf->WindowFrames < PRF_WINDOW)
+		return;
+
+	// Show the window, moving on to the next phase.
+	for (u16 i = 0; i <= PRF_Phase_LEN; i++) {
+		prf->Shown[i] = prf->Window[i];
+		prf->Shown[i].Avg /= PRF_WINDOW;
+	}
+
+	prf->WindowFrames = 0;
+	if (++prf->ShownPhase == PRF_Phase_LEN)
+		prf->ShownPhase = 0;
+}
+
+#endif
@@ -0,0 +1,112 @@
+// Super Grayland: Copyright 2021 Vincent Robinson under the zlib license.
+// See `license.txt` for more information.
+// Before delving into the code, please read `readme_source.txt` to understand the basic design.
+
+#pragma once
+
+#include "common.h"
+
+// PRF Namespace: Frame profiler
+/*
+	The profiler times each phase of a frame of the level mainloop and shows the results in the
+	HUD, so it's possible to see where the time goes while actually playing on a calculator.
+	It is enabled by defining the PROFILE macro, and a warning is issued when it is. When it
+	isn't, every `PRF_` macro compiles to nothing, except for `PRF_time`, which compiles to
+	just the code it times, and the profiler doesn't even exist in `GME_Game`.
+
+	Times are in ticks of `PRF_now`. On the calculator, this is the programmable rate generator
+	running as fast as it can, which ticks about every 40 microseconds, counting its overflows
+	with auto-interrupt 5. Since AMS uses that interrupt for its timers, they stop while the
+	profiler is initialized. On the host, `PRF_now` reads `clock_gettime` through the shim and
+	ticks every nanosecond.
+
+	Every `PRF_WINDOW` frames, the minimum, average, and maximum time of each phase and of the
+	whole frame over those frames are shown, replacing the ones from the window before. The HUD
+	is too small to show every phase at once, so it shows one phase each window, in turn:
+
+	    <phase> <min> <avg> <max>  <frame min> <frame avg> <frame max>
+
+	where `<phase>` is the number of the `PRF_Phase`. Times of a hundred thousand ticks or more
+	are shown as 99999.
+*/
+// #define PROFILE
+
+// The timed phases of a frame
+enum PRF_Phase
+{
+	PRF_Phase_INPUT,
+	PRF_Phase_OBJ_UPDATE,
+	PRF_Phase_SCROLL,
+	PRF_Phase_ANIM,
+	PRF_Phase_BLIT,
+	PRF_Phase_OBJ_DRAW,
+	PRF_Phase_SWAP,
+	PRF_Phase_LEN
+};
+
+// Number of frames that the shown times are taken over
+#define PRF_WINDOW 32
+
+// The shortest, average, and longest time of something over a window
+struct PRF_Stats
+{
+	u32 Min;
+	u32 Avg;
+	u32 Max;
+};
+
+struct PRF_Profiler
+{
+	// The time the frame started at
+	u32 FrameStart;
+	// Time spent in each phase this frame
+	u32 Times[PRF_Phase_LEN];
+
+	// Totals of this window, where `Avg` is a sum until the window ends. The whole frame is
+	// after the phases.
+	struct PRF_Stats Window[PRF_Phase_LEN + 1];
+	u16 WindowFrames;
+
+	// The times of the last window and the phase that the HUD is showing them for
+	struct PRF_Stats Shown[PRF_Phase_LEN + 1];
+	u16 ShownPhase;
+};
+
+#ifdef PROFILE
+
+// Takes over the timer. It is safe to call `PRF_deInit` even if this wasn't called.
+#define PRF_init(prf) PRF_initProfiler(prf)
+// Gives the timer back.
+#define PRF_deInit(prf) PRF_deInitProfiler(prf)
+
+// Starts timing a frame.
+#define PRF_startFrame(prf) ((void)((prf)->FrameStart = PRF_now()))
+// Runs `code`, adding the time it takes to `phase`.
+#define PRF_time(prf, phase, code)						\
+	({													\
+		u32 _prf_start = PRF_now();						\
+		code;											\
+		(prf)->Times[phase] += PRF_now() - _prf_start;	\
+	})
+// Draws the times of the last window in the HUD of the hidden buffer.
+#define PRF_drawHud(prf) PRF_drawProfilerHud(prf)
+// Adds the times of this frame to the window, showing the window once it's full.
+#define PRF_endFrame(prf) PRF_endProfilerFrame(prf)
+
+// The functions behind the macros above, which shouldn't be used directly.
+void PRF_initProfiler(struct PRF_Profiler *prf);
+void PRF_deInitProfiler(struct PRF_Profiler *prf);
+u32 PRF_now(void);
+void PRF_drawProfilerHud(const struct PRF_Profiler *prf);
+void PRF_endProfilerFrame(struct PRF_Profiler *prf);
+
+#else
+
+#define PRF_init(prf)
+#define PRF_deInit(prf)
+#define PRF_startFrame(prf)
+#define PRF_time(prf, phase, code) ({ code; })
+#define PRF_drawHud(prf)
+#define PRF_endFrame(prf)
+
+#endif
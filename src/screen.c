@@ -27,6 +27,89 @@ const SCR_SpriteBuffer TEMP_TILE_SPRITES[] = {
 		{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
 		{0x7E, 0xBD, 0xDB, 0xE7, 0xE7, 0xDB, 0xBD, 0x7E}
 	},
+	{
+		{0x00, 0x00, 0x00, 0x18, 0x18, 0x00, 0x00, 0x00},
+		{0x00, 0x18, 0x24, 0x42, 0x42, 0x24, 0x18, 0x00},
+		{0xFF, 0xE7, 0xC3, 0x81, 0x81, 0xC3, 0xE7, 0xFF}
+	},
+	{
+		{0x00, 0x00, 0x24, 0x00, 0x00, 0x24, 0x00, 0x00},
+		{0x81, 0x42, 0x00, 0x18, 0x18, 0x00, 0x42, 0x81},
+		{0x7E, 0xBD, 0xDB, 0xE7, 0xE7, 0xDB, 0xBD, 0x7E}
+	},
+};
+
+const struct SCR_SpriteAnim TEMP_TILE_ANIMS[] = {
+	{1, 1}, {1, 1}, {1, 1}, {1, 1}, {2, 8}, {1, 1}
+};
+
+const struct SCR_SpriteBank TEMP_TILE_BANK = {
+	.NumSprites = sizeof(TEMP_TILE_SPRITES) / sizeof(*TEMP_TILE_SPRITES),
+	.Sprites = TEMP_TILE_SPRITES,
+	.Anims = TEMP_TILE_ANIMS
+};
+
+// Temporary object sprites. The tester's two frames come first, then Grayford's two frames of
+// two sprites each, and then Super Grayford, whose top right sprite is empty.
+const SCR_SpriteBuffer TEMP_OBJ_SPRITES[] = {
+	{
+		{0xF0, 0x80, 0x80, 0x80, 0x00, 0x00, 0x00, 0x00},
+		{0x00, 0x00, 0x00, 0x00, 0x01, 0x03, 0x07, 0x0F},
+		{0x0F, 0x7F, 0x7F, 0x7F, 0xFE, 0xFC, 0xF8, 0xF0}
+	},
+	{
+		{0x18, 0x3C, 0x7E, 0x18, 0x18, 0x18, 0x18, 0x00},
+		{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3C, 0x3C},
+		{0xE7, 0xC3, 0x81, 0xE7, 0xE7, 0xE7, 0xC3, 0xC3}
+	},
+	{
+		{0x3C, 0x42, 0x95, 0x81, 0xA1, 0x99, 0x42, 0x3C},
+		{0x00, 0x3C, 0x6A, 0x7E, 0x5E, 0x66, 0x3C, 0x00},
+		{0xC3, 0x81, 0x00, 0x00, 0x00, 0x00, 0x81, 0xC3}
+	},
+	{
+		{0x18, 0x7E, 0x99, 0x18, 0x24, 0x24, 0x42, 0xC3},
+		{0x00, 0x00, 0x66, 0x00, 0x00, 0x00, 0x00, 0x00},
+		{0xE7, 0x81, 0x00, 0xE7, 0xC3, 0xC3, 0x81, 0x3C}
+	},
+	{
+		{0x3C, 0x42, 0xA9, 0x81, 0x85, 0x99, 0x42, 0x3C},
+		{0x00, 0x3C, 0x56, 0x7E, 0x7A, 0x66, 0x3C, 0x00},
+		{0xC3, 0x81, 0x00, 0x00, 0x00, 0x00, 0x81, 0xC3}
+	},
+	{
+		{0x18, 0x7E, 0x99, 0x18, 0x28, 0x48, 0x88, 0x0C},
+		{0x00, 0x00, 0x66, 0x00, 0x00, 0x00, 0x00, 0x00},
+		{0xE7, 0x81, 0x00, 0xE7, 0xD7, 0xB7, 0x77, 0xF3}
+	},
+	{
+		{0x00, 0x07, 0x18, 0x20, 0x40, 0x4C, 0x8C, 0x80},
+		{0x00, 0x00, 0x07, 0x1F, 0x3F, 0x33, 0x73, 0x7F},
+		{0xFF, 0xF8, 0xE0, 0xC0, 0x80, 0x80, 0x00, 0x00}
+	},
+	{
+		{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+		{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+		{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}
+	},
+	{
+		{0x80, 0x90, 0x88, 0x47, 0x40, 0x20, 0x18, 0x07},
+		{0x7F, 0x6F, 0x77, 0x38, 0x3F, 0x1F, 0x07, 0x00},
+		{0x00, 0x00, 0x00, 0x80, 0x80, 0xC0, 0xE0, 0xF8}
+	},
+	{
+		{0x01, 0x09, 0x11, 0xE2, 0x02, 0x04, 0x18, 0xE0},
+		{0xFE, 0xF6, 0xEE, 0x1C, 0xFC, 0xF8, 0xE0, 0x00},
+		{0x00, 0x00, 0x00, 0x01, 0x01, 0x03, 0x07, 0x1F}
+	}
+};
+
+const u8 TEMP_OBJ_MASK_INFO[] = {0, 0, 0, 0, 0, 0, 0, SCR_MaskInfo_CLEAR, 0, 0};
+
+const struct SCR_SpriteBank TEMP_OBJ_BANK = {
+	.NumSprites = sizeof(TEMP_OBJ_SPRITES) / sizeof(*TEMP_OBJ_SPRITES),
+	.Sprites = TEMP_OBJ_SPRITES,
+	.MaskInfo = TEMP_OBJ_MASK_INFO
 };
 
 // "SUPER GRAYLAND" text for large screens. Disgusting for now, but will be put into an external
@@ -35,6 +118,54 @@ const u16 TEMP_TITLE[97 * 2] = {
 	0b1110000000000111, 0b1100000000000011, 0b1100111111110011, 0b1100111111110011, 0b1100000000000011, 0b1100000000000011, 0b1111111111111111, 0b1110000000000011, 0b1100000000000011, 0b1100111111111111, 0b1100111111111111, 0b1100000000000011, 0b1100000000000011, 0b1111111111111111, 0b1100000000000011, 0b1100000000000011, 0b1100111001111111, 0b1100111001111111, 0b1100000000000011, 0b1100000000000011, 0b1111111111111111, 0b1111111111110011, 0b1111111111110011, 0b1111111111110011, 0b1111111111110011, 0b1100000000000011, 0b1100000000000011, 0b1111111111111111, 0b1100000001111111, 0b1100000001111111, 0b1111111000000011, 0b1111111000000011, 0b1100000001111111, 0b1100000001111111, 0b1111111111111111, 0b1100000000000011, 0b1100000000000011, 0b1100111001111111, 0b1100111001111111, 0b1100000000000011, 0b1100000000000011, 0b1111111111111111, 0b1100000001110011, 0b1100000001000011, 0b1100111000001111, 0b1100111000111111, 0b1100000000000011, 0b1100000000000011, 0b1111111111111111, 0b1100111000000011, 0b1100111000000011, 0b1100111001110011, 0b1100111111110011, 0b1100000000000011, 0b1100000000000011, 0b1111111111111111, 0b1111111111111111, 0b1111111111111111, 0b1111111111111111, 0b1111111111111111, 0b1111111111111111, 0b1111111111111111, 0b1111111111111111, 0b1100000001110011, 0b1100000001000011, 0b1100111000001111, 0b1100111000111111, 0b1100000000000011, 0b1100000000000011, 0b1111111111111111, 0b1100111111110011, 0b1100111001110011, 0b1100111001110011, 0b1100111001110011, 0b1100000000000011, 0b1100000000000011, 0b1111111111111111, 0b1100000001111111, 0b1100000001111111, 0b1100111001111111, 0b1100111001111111, 0b1100000000000011, 0b1100000000000011, 0b1111111111111111, 0b1100000000000011, 0b1100000000000011, 0b1111111111110011, 0b1111111111110011, 0b1100000000000011, 0b1100000000000011, 0b1111111111111111, 0b1100111000000011, 0b1100111000000011, 0b1100111001110011, 0b1100111001110011, 0b1100000001110011, 0b1100000001110011
 };
 
+// Opens the sprite bank file `name` and points `bank` into it; see the sprite bank file
+// documentation in `screen.h`. Returns TRUE if there is no such file and throws an error if
+// the file is not a valid sprite bank.
+static bool openBank(struct SCR_SpriteBank *bank, const char *name)
+{
+	if (FOpen(name, &bank->File, FM_READ, "sgls") != FS_OK) {
+		COM_zero(&bank->File);
+		return TRUE;
+	}
+
+	// The first two bytes of a variable are its size.
+	const u8 *data = HeapDeref(bank->File.dataH);
+	u16 size = COM_be16(*(const u16 *)data);
+	data += 2;
+
+	const struct SCR_BankHeader *header = (const struct SCR_BankHeader *)data;
+	if (size < sizeof(*header) || memcmp(header->Magic, "SGLS", 4) != 0 ||
+			COM_be16(header->Version) != SCR_BANK_VERSION)
+		COM_throwErr(COM_Error_FORMAT, (char *)name);
+
+	u16 num_sprites = COM_be16(header->NumSprites);
+	u16 flags = COM_be16(header->Flags);
+
+	// Find each section and check that they all fit in the file.
+	u32 used = sizeof(*header);
+
+	bank->Anims = NULL;
+	if (flags & SCR_BankFlag_ANIMS) {
+		bank->Anims = (const struct SCR_SpriteAnim *)(data + used);
+		used += (u32)sizeof(struct SCR_SpriteAnim) * num_sprites;
+	}
+
+	bank->MaskInfo = NULL;
+	if (flags & SCR_BankFlag_MASK_INFO) {
+		bank->MaskInfo = data + used;
+		used += num_sprites;
+	}
+
+	bank->Sprites = (const SCR_SpriteBuffer *)(data + used);
+	used += (u32)sizeof(SCR_SpriteBuffer) * num_sprites;
+
+	if (used > size)
+		COM_throwErr(COM_Error_FORMAT, (char *)name);
+
+	bank->NumSprites = num_sprites;
+	return FALSE;
+}
+
 // TODO: Garbage collect or alloc high?
 void SCR_init(struct SCR_Screen *screen)
 {
@@ -55,14 +186,28 @@ void SCR_init(struct SCR_Screen *screen)
 	if (screen->TileBuffer == NULL)
 		COM_throwErr(COM_Error_MEMORY, "tile buffer");
 
-	/* if (FOpen("sgl\\tiles", &screen->TileBankFile, FM_READ, "sgls") != FS_OK)
-		COM_throwErr(COM_Error_FILE, "sgl\\tiles");
-	screen->TileBank = HeapDeref(screen->TileBankFile.dataH);
-	if (FOpen("sgl\\objects", &screen->ObjBankFile, FM_READ, "sgls") != FS_OK)
-		COM_throwErr(COM_Error_FILE, "sgl\\objects");
-	screen->ObjBank = HeapDeref(screen->ObjBankFile.dataH) */
-
-	screen->TileBank = TEMP_TILE_SPRITES;
+	screen->AnimTiles = HeapAllocPtr(sizeof(struct SCR_TB_AnimTile) * SCR_TB_NUM_CELLS);
+	if (screen->AnimTiles == NULL)
+		COM_throwErr(COM_Error_MEMORY, "animated tiles");
+	screen->AnimSlots = HeapAllocPtr(sizeof(u16) * SCR_TB_NUM_CELLS);
+	if (screen->AnimSlots == NULL)
+		COM_throwErr(COM_Error_MEMORY, "animated tiles");
+	memset(screen->AnimSlots, 0, sizeof(u16) * SCR_TB_NUM_CELLS);
+
+	screen->SavedRects = HeapAllocPtr(sizeof(struct SCR_SavedRect) * SCR_MAX_SAVED_RECTS * 2);
+	if (screen->SavedRects == NULL)
+		COM_throwErr(COM_Error_MEMORY, "object backgrounds");
+
+	screen->BlitWidth = SCR_DEFAULT_BLIT_WIDTH;
+	SCR_TB_markDirty(screen, SCR_TB_ALL_ROWS);
+
+	// Nothing makes sprite bank files for the calculator yet, so the sprites built into the
+	// program stand in for missing banks, just like the built in test map does for a missing
+	// level. Only the host benchmark writes real banks.
+	if (openBank(&screen->TileBank, "sgl\\tiles"))
+		screen->TileBank = TEMP_TILE_BANK;
+	if (openBank(&screen->ObjBank, "sgl\\objects"))
+		screen->ObjBank = TEMP_OBJ_BANK;
 
 	return;
 }
@@ -75,9 +220,18 @@ void SCR_deInit(struct SCR_Screen *screen)
 		HeapFreePtr(screen->GrayBuffer);
 	if (screen->TileBuffer != NULL)
 		HeapFreePtr(screen->TileBuffer);
-
-	// FClose(&screen->TileBankFile);
-	// FClose(&screen->ObjBankFile);
+	SCR_TB_deInitLevel(screen);
+	if (screen->AnimTiles != NULL)
+		HeapFreePtr(screen->AnimTiles);
+	if (screen->AnimSlots != NULL)
+		HeapFreePtr(screen->AnimSlots);
+	if (screen->SavedRects != NULL)
+		HeapFreePtr(screen->SavedRects);
+
+	if (screen->TileBank.File.dataH != H_NULL)
+		FClose(&screen->TileBank.File);
+	if (screen->ObjBank.File.dataH != H_NULL)
+		FClose(&screen->ObjBank.File);
 
 	COM_zero(screen);
 }
@@ -170,7 +324,7 @@ void SCR_drawTile(const struct SCR_Screen *screen, SCR_Pixel x, SCR_Pixel y,
 	u8 *dark  = GrayDBufGetHiddenPlane(DARK_PLANE);
 	u8 *light = GrayDBufGetHiddenPlane(LIGHT_PLANE);
 
-	const SCR_SpriteBuffer *bank = screen->TileBank;
+	const SCR_SpriteBuffer *bank = screen->TileBank.Sprites;
 
 	ClipSprite8(x, y, SCR_SPRITE_SIZE, bank[tile->Back][SCR_SPRITE_MASK], dark, SPRT_AND);
 	ClipSprite8(x, y, SCR_SPRITE_SIZE, bank[tile->Back][SCR_SPRITE_DARK], dark, SPRT_OR);
@@ -183,87 +337,572 @@ void SCR_drawTile(const struct SCR_Screen *screen, SCR_Pixel x, SCR_Pixel y,
 	ClipSprite8(x, y, SCR_SPRITE_SIZE, bank[tile->Front][SCR_SPRITE_LIGHT], light, SPRT_OR);
 }
 
-void SCR_drawObject(const struct OBJ_Object *obj)
+// Every byte with the order of its bits reversed, for flipping sprites horizontally
+#define reverse2(n) (n), (n) + 2 * 64, (n) + 1 * 64, (n) + 3 * 64
+#define reverse4(n) reverse2(n), reverse2((n) + 2 * 16), reverse2((n) + 1 * 16), \
+		reverse2((n) + 3 * 16)
+#define reverse6(n) reverse4(n), reverse4((n) + 2 * 4), reverse4((n) + 1 * 4), \
+		reverse4((n) + 3 * 4)
+
+static const u8 BIT_REVERSE[256] = {reverse6(0), reverse6(2), reverse6(1), reverse6(3)};
+
+#undef reverse6
+#undef reverse4
+#undef reverse2
+
+// Draws one sprite with its mask to the game area with the top left corner at (`x`, `y`),
+// clipping it to the edges. `dark` and `light` point to the top left of the game area. Both
+// planes are drawn in the same pass over the rows. This has to use u8s since a sprite can
+// start on an odd byte, which the 68k can't access u16s at.
+//
+// Pixels under the foreground plane `fg` of the tile buffer are left alone. `fg_x` is the bit
+// in a row of the plane at the left edge of the screen and `fg_y` the row of the plane at the
+// top of the game area, like what `SCR_drawTileBuffer` starts copying from.
+//
+// The bytes drawn over are saved to `save` first if it isn't NULL. Its height is set to zero
+// if the sprite is entirely off the screen. If `opaque` is set, the sprite's mask is known to
+// be all zeros, so it isn't read.
+static void drawObjSprite(u8 *dark, u8 *light, const u8 *fg, u16 fg_x, u16 fg_y, s16 x, s16 y,
+		const SCR_SpriteBuffer *sprite, bool flip_x, bool flip_y, bool opaque,
+		struct SCR_SavedRect *save)
+{
+	s16 col = x >> 3;
+	u16 shift = SCR_SPRITE_SIZE - (x & 7);
+
+	// Find the foreground under the two bytes, which are usually not aligned to the bytes of
+	// the tile buffer. Since rows hold the ring twice, going left of the first copy is the
+	// same as going left of the second one.
+	s16 fg_bit = fg_x + col * SCR_SPRITE_SIZE;
+	if (fg_bit < 0)
+		fg_bit += SCR_TB_RING_WIDTH * SCR_SPRITE_SIZE;
+
+	u16 fg_shift = fg_bit & 7;
+	fg += fg_bit >> 3;
+
+	// Each row of the sprite covers the byte at `col` and the one after it.
+	bool draw_left = col >= 0 && col < SCR_WIDTH_BYTES;
+	bool draw_right = col + 1 >= 0 && col + 1 < SCR_WIDTH_BYTES;
+
+	s16 row = COM_max(0, -y);
+	s16 row_end = COM_min(SCR_SPRITE_SIZE, SCR_GAME_HEIGHT - y);
+
+	if ((!draw_left && !draw_right) || row >= row_end) {
+		if (save != NULL)
+			save->Height = 0;
+		return;
+	}
+
+	if (save != NULL) {
+		save->Height = row_end - row;
+		save->Width = draw_left + draw_right;
+		save->Offset = (y + row) * SCR_SCREEN_BUFFER_WIDTH + (draw_left ? col : col + 1);
+	}
+
+	dark += (y + row) * SCR_SCREEN_BUFFER_WIDTH + col;
+	light += (y + row) * SCR_SCREEN_BUFFER_WIDTH + col;
+
+	fg_y += y + row;
+	if (fg_y >= SCR_TB_PLANE_HEIGHT)
+		fg_y -= SCR_TB_PLANE_HEIGHT;
+	const u8 *fg_it = fg + fg_y * SCR_TB_FULL_PLANE_WIDTH;
+
+	for (u16 save_row = 0; row < row_end; row++, save_row++) {
+		if (save != NULL) {
+			const u8 *from_dark = draw_left ? dark : dark + 1;
+			const u8 *from_light = draw_left ? light : light + 1;
+
+			save->Dark[save_row][0] = from_dark[0];
+			save->Dark[save_row][1] = from_dark[1];
+			save->Light[save_row][0] = from_light[0];
+			save->Light[save_row][1] = from_light[1];
+		}
+
+		u16 src_row = flip_y ? SCR_SPRITE_SIZE - 1 - row : row;
+
+		u8 dark_row = (*sprite)[SCR_SPRITE_DARK][src_row];
+		u8 light_row = (*sprite)[SCR_SPRITE_LIGHT][src_row];
+
+		if (flip_x) {
+			dark_row = BIT_REVERSE[dark_row];
+			light_row = BIT_REVERSE[light_row];
+		}
+
+		// The inverted mask is what the sprite covers, which is everything for opaque sprites.
+		u8 solid = 0xFF;
+		if (!opaque) {
+			solid = ~(*sprite)[SCR_SPRITE_MASK][src_row];
+			if (flip_x)
+				solid = BIT_REVERSE[solid];
+		}
+
+		u16 fg_bits = (u16)(((fg_it[0] << 8) | fg_it[1]) << fg_shift) |
+				(fg_it[2] >> (SCR_SPRITE_SIZE - fg_shift));
+
+		// Line the row up with the two bytes it covers. The mask is inverted first so the
+		// zeros shifted in leave the background alone.
+		u16 cover = (solid << shift) & ~fg_bits;
+		u16 dark_bits = (dark_row << shift) & cover;
+		u16 light_bits = (light_row << shift) & cover;
+
+		if (draw_left) {
+			dark[0] = (dark[0] & ~(cover >> 8)) | (dark_bits >> 8);
+			light[0] = (light[0] & ~(cover >> 8)) | (light_bits >> 8);
+		}
+		if (draw_right) {
+			dark[1] = (dark[1] & ~cover) | dark_bits;
+			light[1] = (light[1] & ~cover) | light_bits;
+		}
+
+		dark += SCR_SCREEN_BUFFER_WIDTH;
+		light += SCR_SCREEN_BUFFER_WIDTH;
+
+		fg_it += SCR_TB_FULL_PLANE_WIDTH;
+		if (fg_it == fg + SCR_TB_PLANE_SIZE)
+			fg_it = fg;
+	}
+}
+
+// Draws `obj` with its left edge at `x` and its bottom edge at `bottom` in the game area, which
+// stay s32s until the object is known to be on the screen.
+static void drawObjectAt(struct SCR_Screen *screen, const struct MAP_Map *map,
+		const struct OBJ_Object *obj, s32 x, s32 bottom)
 {
 	const struct OBJ_ObjectDef *def = OBJ_getDef(obj->Type);
-	(void)def;
-	// TODO: This needs to be implemented
+
+	u16 width = def->ExtraWidth + 1;
+	u16 height = def->ExtraHeight + 1;
+
+	s32 top = bottom - height * SCR_SPRITE_SIZE;
+
+	if (x >= SCR_WIDTH || x + width * SCR_SPRITE_SIZE <= 0 || top >= SCR_GAME_HEIGHT ||
+			bottom <= 0)
+		return;
+
+	u8 *dark  = GrayDBufGetHiddenPlane(DARK_PLANE);
+	u8 *light = GrayDBufGetHiddenPlane(LIGHT_PLANE);
+
+	u16 is = SCR_SCREEN_BUFFER_WIDTH * SCR_HUD_HEIGHT;
+	if (SCR_isLargeScreen())
+		is += SCR_LARGE_OFFSET_BYTES;
+
+	dark += is;
+	light += is;
+
+	const u8 *fg = screen->TileBuffer + SCR_TB_FG_OFFSET;
+	u16 fg_x = screen->TileOriginX * SCR_SPRITE_SIZE + FXD_numer(MAP_Scroll, map->ScrollX);
+	u16 fg_y = screen->TileOriginY * SCR_SPRITE_SIZE + FXD_numer(MAP_Scroll, map->ScrollY);
+
+	const struct SCR_SpriteBank *bank = &screen->ObjBank;
+	u16 frame = def->Sprite + obj->SpriteOffset * width * height;
+
+	u16 hidden = GrayDBufGetHiddenIdx();
+	struct SCR_SavedRect *saves = screen->SavedRects + SCR_MAX_SAVED_RECTS * hidden;
+	bool overflowed = FALSE;
+
+	// Flipping the object also swaps which sprite goes where, so each position takes its
+	// sprite from the mirrored position.
+	for (u16 sprite_y = 0; sprite_y < height; sprite_y++) {
+		u16 src_y = obj->FlipAcrossY ? height - 1 - sprite_y : sprite_y;
+
+		for (u16 sprite_x = 0; sprite_x < width; sprite_x++) {
+			u16 src_x = obj->FlipAcrossX ? width - 1 - sprite_x : sprite_x;
+			u16 sprite = frame + src_y * width + src_x;
+
+			u8 mask_info = bank->MaskInfo != NULL ? bank->MaskInfo[sprite] : 0;
+			if (mask_info & SCR_MaskInfo_CLEAR)
+				continue;
+
+			struct SCR_SavedRect *save = NULL;
+			if (screen->NumSavedRects[hidden] < SCR_MAX_SAVED_RECTS)
+				save = &saves[screen->NumSavedRects[hidden]];
+			else
+				overflowed = TRUE;
+
+			drawObjSprite(dark, light, fg, fg_x, fg_y, x + sprite_x * SCR_SPRITE_SIZE,
+					top + sprite_y * SCR_SPRITE_SIZE, &bank->Sprites[sprite],
+					obj->FlipAcrossX, obj->FlipAcrossY,
+					(mask_info & SCR_MaskInfo_OPAQUE) != 0, save);
+
+			if (save != NULL && save->Height != 0)
+				screen->NumSavedRects[hidden]++;
+		}
+	}
+
+	if (!overflowed)
+		return;
+
+	// Mark the rows of tiles under the object instead, which are offset by the vertical shift.
+	u16 shift_up = FXD_numer(MAP_Scroll, map->ScrollY);
+	u16 first = (COM_max(top, 0) + shift_up) / SCR_SPRITE_SIZE;
+	u16 last = (COM_min(bottom, SCR_GAME_HEIGHT) - 1 + shift_up) / SCR_SPRITE_SIZE;
+
+	u16 ring_row = screen->TileOriginY + first;
+	for (u16 row = first; row <= last; row++, ring_row++) {
+		if (ring_row >= SCR_TB_SPRITES_HEIGHT)
+			ring_row -= SCR_TB_SPRITES_HEIGHT;
+		SCR_TB_markDirty(screen, 1 << ring_row);
+	}
+}
+
+void SCR_drawObject(struct SCR_Screen *screen, const struct MAP_Map *map,
+		const struct OBJ_Object *obj)
+{
+	// Objects are positioned from the bottom left.
+	s32 x = FXD_convert(OBJ_Pos, MAP_Scroll, obj->PosX) - map->ScrollX;
+	s32 bottom = FXD_convert(OBJ_Pos, MAP_Scroll, obj->PosY) - map->ScrollY;
+
+	// In levels that wrap, the screen can show the level more than once, so the object is also
+	// drawn a level's width and height away. Copies off the screen return straight away.
+	s32 level_x = FXD_convert(MAP_Pos, MAP_Scroll, (s32)map->SizeX);
+	s32 level_y = FXD_convert(MAP_Pos, MAP_Scroll, (s32)map->SizeY);
+	s16 wrap_x = map->WrapX == MAP_Wrap_LEVEL;
+	s16 wrap_y = map->WrapY == MAP_Wrap_LEVEL;
+
+	for (s16 copy_y = -wrap_y; copy_y <= wrap_y; copy_y++) {
+		for (s16 copy_x = -wrap_x; copy_x <= wrap_x; copy_x++)
+			drawObjectAt(screen, map, obj, x + copy_x * level_x, bottom + copy_y * level_y);
+	}
 }
 
-// TODO: Only shift in one direction? Could speed it up.
-void SCR_drawTileBuffer(const struct SCR_Screen *screen, SCR_Pixel shift_left, SCR_Pixel shift_up)
+// The four pixel font for the HUD, which only has digits. Each row of a character is a nibble,
+// top row first, where the low bit is always clear to space the characters apart.
+static const u16 HUD_DIGITS[10] = {
+	0xEAAE, 0x4C4E, 0xC24E, 0xE62E, 0xAAE2, 0xEC2C, 0x8EAE, 0xE244, 0xEEAE, 0xEAE2
+};
+
+void SCR_drawHudText(const char *text)
 {
+	u8 *dark  = GrayDBufGetHiddenPlane(DARK_PLANE);
+	u8 *light = GrayDBufGetHiddenPlane(LIGHT_PLANE);
+
+	if (SCR_isLargeScreen()) {
+		dark += SCR_LARGE_OFFSET_BYTES;
+		light += SCR_LARGE_OFFSET_BYTES;
+	}
+
+	// Two characters fit in each byte, so pairs of characters are drawn a byte at a time. Once
+	// the text ends, `text` stays on its terminator so the rest of the HUD is cleared.
+	for (u16 byte = 0; byte < SCR_WIDTH_BYTES; byte++) {
+		u16 left = 0;
+		u16 right = 0;
+
+		if (*text != '\0') {
+			if (*text >= '0' && *text <= '9')
+				left = HUD_DIGITS[*text - '0'];
+			text++;
+		}
+		if (*text != '\0') {
+			if (*text >= '0' && *text <= '9')
+				right = HUD_DIGITS[*text - '0'];
+			text++;
+		}
+
+		for (u16 row = 0; row < SCR_HUD_HEIGHT; row++) {
+			u16 shift = (SCR_HUD_HEIGHT - 1 - row) * 4;
+			u8 pixels = ((left >> shift) & 0xF) << 4 | ((right >> shift) & 0xF);
+
+			dark[row * SCR_SCREEN_BUFFER_WIDTH + byte] = pixels;
+			light[row * SCR_SCREEN_BUFFER_WIDTH + byte] = pixels;
+		}
+	}
+}
+
+// Shifts one word of the tile buffer plane `src` left by `shift` pixels, pulling in pixels from
+// the next word. Shifting by zero is a plain copy; `shift` must be a constant so this folds.
+#define shiftWord(src, i, shift)											\
+		((shift) == 0 ? (src)[i] : COM_be16((COM_be16((src)[i]) << (shift)) |	\
+				(COM_be16((src)[(i) + 1]) >> (16 - (shift)))))
+
+// Defines `blitShift<shift>`, a version of the tile buffer blit loop with the shift amount fixed
+// at compile time. On the 68k, shifts by a variable cost two cycles per bit, while shifts by a
+// constant are much cheaper and shifts by zero disappear entirely, so there is one of these for
+// each possible shift, and `SCR_drawTileBuffer` picks one from `BLITS`. Shifts of eight and up
+// are for origins on odd bytes. `dark` and `light` are the first words of the screen to draw to
+// and `it` and `it_end` are the first and end row of the dark plane of the tile buffer.
+#define defineBlit(shift)													\
+static void blitShift##shift(u16 *dark, u16 *light, const u16 *it, const u16 *it_end)	\
+{																			\
+	for (; it < it_end; it += SCR_TB_FULL_PLANE_WIDTH / 2,					\
+			dark += SCR_SCREEN_BUFFER_WIDTH / 2, light += SCR_SCREEN_BUFFER_WIDTH / 2) {	\
+		const u16 *it_light = it + SCR_TB_PLANE_SIZE / 2;					\
+		for (u16 i = 0; i < SCR_WIDTH_BYTES / 2; i++) {						\
+			dark[i] = shiftWord(it, i, shift);								\
+			light[i] = shiftWord(it_light, i, shift);						\
+		}																	\
+	}																		\
+}
+
+defineBlit(0)
+defineBlit(1)
+defineBlit(2)
+defineBlit(3)
+defineBlit(4)
+defineBlit(5)
+defineBlit(6)
+defineBlit(7)
+defineBlit(8)
+defineBlit(9)
+defineBlit(10)
+defineBlit(11)
+defineBlit(12)
+defineBlit(13)
+defineBlit(14)
+defineBlit(15)
+
+#undef defineBlit
+#undef shiftWord
+
+// A u32 that only needs to be aligned like a u16. The screen rows are 30 bytes long, so every
+// other row starts on an address that is not a multiple of four, which the 68k does not care
+// about, but the compiler has to be told about on other processors.
+typedef u32 __attribute__((aligned(2), may_alias)) WordAlignedU32;
+
+// Same as `shiftWord`, but for the `i`th u32 of `src`, which is still a pointer to u16s. Only the
+// next u16 is needed to fill in the shifted pixels since the shift is less than sixteen.
+#define shiftLong(src, i, shift)												\
+		((shift) == 0 ? ((const WordAlignedU32 *)(src))[i] :					\
+				COM_be32((COM_be32(((const WordAlignedU32 *)(src))[i]) << (shift)) |	\
+				(COM_be16((src)[(i) * 2 + 2]) >> (16 - (shift)))))
+
+// Same as `defineBlit`, but defines `blitLongShift<shift>`, which copies u32s instead of u16s.
+// That halves the number of loads, stores, and shift instructions per row.
+#define defineLongBlit(shift)												\
+static void blitLongShift##shift(u16 *dark, u16 *light, const u16 *it, const u16 *it_end)	\
+{																			\
+	for (; it < it_end; it += SCR_TB_FULL_PLANE_WIDTH / 2,					\
+			dark += SCR_SCREEN_BUFFER_WIDTH / 2, light += SCR_SCREEN_BUFFER_WIDTH / 2) {	\
+		const u16 *it_light = it + SCR_TB_PLANE_SIZE / 2;					\
+		for (u16 i = 0; i < SCR_WIDTH_BYTES / 4; i++) {						\
+			((WordAlignedU32 *)dark)[i] = shiftLong(it, i, shift);			\
+			((WordAlignedU32 *)light)[i] = shiftLong(it_light, i, shift);	\
+		}																	\
+	}																		\
+}
+
+defineLongBlit(0)
+defineLongBlit(1)
+defineLongBlit(2)
+defineLongBlit(3)
+defineLongBlit(4)
+defineLongBlit(5)
+defineLongBlit(6)
+defineLongBlit(7)
+defineLongBlit(8)
+defineLongBlit(9)
+defineLongBlit(10)
+defineLongBlit(11)
+defineLongBlit(12)
+defineLongBlit(13)
+defineLongBlit(14)
+defineLongBlit(15)
+
+#undef defineLongBlit
+#undef shiftLong
+
+// A blit loop; see `defineBlit`.
+typedef void (*BlitFunc)(u16 *dark, u16 *light, const u16 *it, const u16 *it_end);
+
+// Jump table of blit loops indexed by the blit width and left shift.
+static const BlitFunc BLITS[SCR_BlitWidth_LEN][SCR_SPRITE_SIZE * 2] = {
+	{
+		blitShift0,  blitShift1,  blitShift2,  blitShift3,
+		blitShift4,  blitShift5,  blitShift6,  blitShift7,
+		blitShift8,  blitShift9,  blitShift10, blitShift11,
+		blitShift12, blitShift13, blitShift14, blitShift15
+	},
+	{
+		blitLongShift0,  blitLongShift1,  blitLongShift2,  blitLongShift3,
+		blitLongShift4,  blitLongShift5,  blitLongShift6,  blitLongShift7,
+		blitLongShift8,  blitLongShift9,  blitLongShift10, blitLongShift11,
+		blitLongShift12, blitLongShift13, blitLongShift14, blitLongShift15
+	}
+};
+
+// Blits `rows` rows of pixels with `blit`, starting `row` rows into the game area. `dark` and
+// `light` are the top of the game area, `plane` is the start of the origin column in the top row
+// of the ring, and `first_row` is the row of pixels in the ring that the game area starts at.
+static void blitRows(BlitFunc blit, u16 *dark, u16 *light, const u16 *plane, u16 first_row,
+		u16 row, u16 rows)
+{
+	dark += row * (SCR_SCREEN_BUFFER_WIDTH / 2);
+	light += row * (SCR_SCREEN_BUFFER_WIDTH / 2);
+
+	u16 tb_row = first_row + row;
+	if (tb_row >= SCR_TB_PLANE_HEIGHT)
+		tb_row -= SCR_TB_PLANE_HEIGHT;
+
+	const u16 *it = plane + tb_row * (SCR_TB_FULL_PLANE_WIDTH / 2);
+
+	if (tb_row + rows <= SCR_TB_PLANE_HEIGHT) {
+		blit(dark, light, it, it + rows * (SCR_TB_FULL_PLANE_WIDTH / 2));
+	} else {
+		// The rows run past the bottom of the ring, so draw the rest from the top.
+		u16 before = SCR_TB_PLANE_HEIGHT - tb_row;
+
+		blit(dark, light, it, plane + SCR_TB_PLANE_SIZE / 2);
+		blit(dark + before * (SCR_SCREEN_BUFFER_WIDTH / 2),
+				light + before * (SCR_SCREEN_BUFFER_WIDTH / 2),
+				plane, plane + (rows - before) * (SCR_TB_FULL_PLANE_WIDTH / 2));
+	}
+}
+
+// Erases the objects drawn to the hidden gray buffer by putting back what they covered, in the
+// reverse order they were drawn so that overlapping objects come off in the right order.
+static void restoreSavedRects(struct SCR_Screen *screen, u16 hidden)
+{
+	u8 *dark  = GrayDBufGetHiddenPlane(DARK_PLANE);
+	u8 *light = GrayDBufGetHiddenPlane(LIGHT_PLANE);
+
+	u16 is = SCR_SCREEN_BUFFER_WIDTH * SCR_HUD_HEIGHT;
+	if (SCR_isLargeScreen())
+		is += SCR_LARGE_OFFSET_BYTES;
+
+	dark += is;
+	light += is;
+
+	const struct SCR_SavedRect *saves = screen->SavedRects + SCR_MAX_SAVED_RECTS * hidden;
+
+	for (s16 i = screen->NumSavedRects[hidden] - 1; i >= 0; i--) {
+		const struct SCR_SavedRect *save = &saves[i];
+		u8 *dark_it = dark + save->Offset;
+		u8 *light_it = light + save->Offset;
+
+		for (u16 row = 0; row < save->Height; row++) {
+			dark_it[0] = save->Dark[row][0];
+			light_it[0] = save->Light[row][0];
+			if (save->Width == 2) {
+				dark_it[1] = save->Dark[row][1];
+				light_it[1] = save->Light[row][1];
+			}
+
+			dark_it += SCR_SCREEN_BUFFER_WIDTH;
+			light_it += SCR_SCREEN_BUFFER_WIDTH;
+		}
+	}
+
+	screen->NumSavedRects[hidden] = 0;
+}
+
+void SCR_drawTileBuffer(struct SCR_Screen *screen, SCR_Pixel shift_left, SCR_Pixel shift_up)
+{
+	// Only the rows that changed since this gray buffer was last drawn to need to be drawn, and
+	// when nothing changed, nothing needs to be done at all besides erasing the objects.
+	u16 hidden = GrayDBufGetHiddenIdx();
+	u16 *dirty = &screen->DirtyRows[hidden];
+
+	if (*dirty == SCR_TB_ALL_ROWS)
+		screen->NumSavedRects[hidden] = 0;
+	else
+		restoreSavedRects(screen, hidden);
+
+	if (*dirty == 0)
+		return;
+
 	// There are a lot of divisions by two because this function uses u16s instead of u8s, which
-	// are _vaaastly_ faster, tripling the framerate. Potentially, u32s might be faster, but
-	// the screen buffer rows are 30 bytes, which is not divisible by four, so there's no way
-	// to use them.
+	// are _vaaastly_ faster, tripling the framerate. The blit loops themselves may copy u32s
+	// instead, depending on `BlitWidth`.
 
 	u16 *dark  = GrayDBufGetHiddenPlane(DARK_PLANE);
 	u16 *light = GrayDBufGetHiddenPlane(LIGHT_PLANE);
 
-	s16 v_shift = shift_up * SCR_TB_FULL_PLANE_WIDTH;
-
-	// Tile buffer counter and end position
-	u16 *it = (u16 *)screen->TileBuffer + v_shift / 2;
-	u16 *it_end = (u16 *)screen->TileBuffer +
-			(SCR_TB_PLANE_SIZE - (SCR_SPRITE_SIZE - v_shift) - SCR_TB_SPRITES_WIDTH) / 2;
-
 	// Screen buffer counter
 	u16 is = SCR_SCREEN_BUFFER_WIDTH / 2 * SCR_HUD_HEIGHT;
 
 	if (SCR_isLargeScreen())
 		is += SCR_LARGE_OFFSET_BYTES / 2;
 
-	for (; it < it_end; it += SCR_TB_FULL_PLANE_WIDTH / 2, is += SCR_SCREEN_BUFFER_WIDTH / 2) {
-		for (u16 i = 0; i < (SCR_TB_PLANE_WIDTH - 1) / 2; i++) {
-			// Leave as-is. GCC optimizes it better all together like this instead of in
-			// separate variables.
-			*(dark + is + i) = (*(it + i) << shift_left) |
-					(*(it + i + 1) >> (16 - shift_left));
-			*(light + is + i) = (*(it + i + SCR_TB_PLANE_SIZE / 2) << shift_left) |
-					(*(it + i + SCR_TB_PLANE_SIZE / 2 + 1) >> (16 - shift_left));
+	dark += is;
+	light += is;
+
+	// Start of the first copy of the origin column in the top row of the ring. An odd origin
+	// starts one byte early, which is shifted out.
+	const u16 *plane = (const u16 *)screen->TileBuffer + screen->TileOriginX / 2;
+	u16 shift = shift_left + (screen->TileOriginX & 1) * SCR_SPRITE_SIZE;
+
+	u16 first_row = screen->TileOriginY * SCR_SPRITE_SIZE + shift_up;
+
+	BlitFunc blit = BLITS[screen->BlitWidth][shift];
+
+	if (*dirty == SCR_TB_ALL_ROWS) {
+		blitRows(blit, dark, light, plane, first_row, 0, SCR_GAME_HEIGHT);
+	} else {
+		// Find runs of dirty rows of tiles from the top of the screen and blit each run at once.
+		// The rows on the screen are offset from the rows of tiles by the vertical shift.
+		u16 ring_row = screen->TileOriginY;
+		s16 run_start = -1;
+
+		for (s16 y = -shift_up; y < SCR_GAME_HEIGHT; y += SCR_SPRITE_SIZE) {
+			bool is_dirty = (*dirty >> ring_row) & 1;
+
+			if (is_dirty && run_start < 0)
+				run_start = COM_max(y, 0);
+			if (!is_dirty && run_start >= 0) {
+				blitRows(blit, dark, light, plane, first_row, run_start, y - run_start);
+				run_start = -1;
+			}
+
+			if (++ring_row == SCR_TB_SPRITES_HEIGHT)
+				ring_row = 0;
 		}
+
+		if (run_start >= 0)
+			blitRows(blit, dark, light, plane, first_row, run_start,
+					SCR_GAME_HEIGHT - run_start);
 	}
+
+	*dirty = 0;
 }
 
 void SCR_scroll(struct SCR_Screen *screen, struct MAP_Map *map, MAP_Scroll shift_x,
 		MAP_Scroll shift_y)
 {
-	MAP_Scroll old_scroll_x = map->ScrollX;
-	map->ScrollX += shift_x;
+	if (shift_x != 0 || shift_y != 0)
+		SCR_TB_markDirty(screen, SCR_TB_ALL_ROWS);
+
+	MAP_Pos old_tile_x = FXD_convert(MAP_Scroll, MAP_Pos, map->ScrollX);
+	MAP_Pos old_tile_y = FXD_convert(MAP_Scroll, MAP_Pos, map->ScrollY);
 
-	// If we scrolled over a tile boundary after the addition, the tile buffer needs to be
-	// shifted and the empty column filled with tiles.
-	if (FXD_floor(MAP_Scroll, map->ScrollX) - FXD_floor(MAP_Scroll, old_scroll_x) > 0) {
-		SCR_TB_shift(screen, SCR_TB_Dir_LEFT, 1);
-		SCR_TB_drawTileColumn(screen, map,
-				FXD_convert(MAP_Scroll, MAP_Pos, map->ScrollX) + SCR_SPRITES_X,
-				FXD_convert(MAP_Scroll, MAP_Pos, map->ScrollY),
-				SCR_TB_PLANE_WIDTH - 1);
-	} else if (FXD_floor(MAP_Scroll, map->ScrollX) - FXD_floor(MAP_Scroll, old_scroll_x) < 0) {
-		SCR_TB_shift(screen, SCR_TB_Dir_RIGHT, 1);
-		SCR_TB_drawTileColumn(screen, map,
-				FXD_convert(MAP_Scroll, MAP_Pos, map->ScrollX),
-				FXD_convert(MAP_Scroll, MAP_Pos, map->ScrollY),
-				0);
-	}
-
-	// This must be added _after_ shifting the X or else it messes up the shifting code.
-	MAP_Scroll old_scroll_y = map->ScrollY;
+	map->ScrollX += shift_x;
 	map->ScrollY += shift_y;
 
-	if (FXD_floor(MAP_Scroll, map->ScrollY) - FXD_floor(MAP_Scroll, old_scroll_y) > 0) {
-		SCR_TB_shift(screen, SCR_TB_Dir_UP, 1);
-		SCR_TB_drawTileRow(screen, map,
-				FXD_convert(MAP_Scroll, MAP_Pos, map->ScrollX),
-				FXD_convert(MAP_Scroll, MAP_Pos, map->ScrollY) + SCR_SPRITES_Y,
-				SCR_TB_PLANE_SIZE - SCR_TB_SPRITES_WIDTH);
-	} else if (FXD_floor(MAP_Scroll, map->ScrollY) - FXD_floor(MAP_Scroll, old_scroll_y) < 0) {
-		SCR_TB_shift(screen, SCR_TB_Dir_DOWN, 1);
-		SCR_TB_drawTileRow(screen, map,
-				FXD_convert(MAP_Scroll, MAP_Pos, map->ScrollX),
-				FXD_convert(MAP_Scroll, MAP_Pos, map->ScrollY),
-				0);
+	MAP_Pos tile_x = FXD_convert(MAP_Scroll, MAP_Pos, map->ScrollX);
+	MAP_Pos tile_y = FXD_convert(MAP_Scroll, MAP_Pos, map->ScrollY);
+
+	// Streamed maps need the new tiles in their window before they can be drawn.
+	MAP_pageWindow(map, tile_x, SCR_TB_PLANE_WIDTH);
+
+	// Number of tiles crossed in each direction, which is the number of columns and rows that
+	// have to be shifted in
+	u16 cols = COM_abs(tile_x - old_tile_x);
+	u16 rows = COM_abs(tile_y - old_tile_y);
+
+	// Drawing just the columns and rows that were shifted in is cheaper unless they add up to
+	// at least a whole buffer of tiles, which is also when the whole buffer has shifted out.
+	if ((s32)cols * SCR_TB_SPRITES_HEIGHT + (s32)rows * SCR_TB_PLANE_WIDTH >=
+			SCR_TB_PLANE_WIDTH * SCR_TB_SPRITES_HEIGHT) {
+		SCR_TB_drawAllTiles(screen, map, tile_x, tile_y);
+		return;
+	}
+
+	// The columns are filled in before shifting vertically, so they use the old row.
+	if (tile_x > old_tile_x) {
+		SCR_TB_shift(screen, SCR_TB_Dir_LEFT, cols);
+		for (u16 x = SCR_TB_PLANE_WIDTH - cols; x < SCR_TB_PLANE_WIDTH; x++)
+			SCR_TB_drawTileColumn(screen, map, tile_x + x, old_tile_y, x);
+	} else if (tile_x < old_tile_x) {
+		SCR_TB_shift(screen, SCR_TB_Dir_RIGHT, cols);
+		for (u16 x = 0; x < cols; x++)
+			SCR_TB_drawTileColumn(screen, map, tile_x + x, old_tile_y, x);
+	}
+
+	if (tile_y > old_tile_y) {
+		SCR_TB_shift(screen, SCR_TB_Dir_UP, rows);
+		for (u16 y = SCR_TB_SPRITES_HEIGHT - rows; y < SCR_TB_SPRITES_HEIGHT; y++)
+			SCR_TB_drawTileRow(screen, map, tile_x, tile_y + y, y);
+	} else if (tile_y < old_tile_y) {
+		SCR_TB_shift(screen, SCR_TB_Dir_DOWN, rows);
+		for (u16 y = 0; y < rows; y++)
+			SCR_TB_drawTileRow(screen, map, tile_x, tile_y + y, y);
 	}
 }
 
@@ -273,8 +912,13 @@ void SCR_scrollAbsolute(struct SCR_Screen *screen, struct MAP_Map *map, MAP_Scro
 	map->ScrollX = scroll_x;
 	map->ScrollY = scroll_y;
 
-	SCR_TB_drawAllTiles(screen, map,
-			FXD_convert(MAP_Scroll, MAP_Pos, scroll_x), FXD_convert(MAP_Scroll, MAP_Pos, scroll_x));
+	MAP_Pos tile_x = FXD_convert(MAP_Scroll, MAP_Pos, scroll_x);
+	MAP_Pos tile_y = FXD_convert(MAP_Scroll, MAP_Pos, scroll_y);
+
+	SCR_TB_markDirty(screen, SCR_TB_ALL_ROWS);
+
+	MAP_pageWindow(map, tile_x, SCR_TB_PLANE_WIDTH);
+	SCR_TB_drawAllTiles(screen, map, tile_x, tile_y);
 }
 
 #ifdef DEBUG
@@ -322,81 +966,268 @@ void SCR_dispError(const char *error, const char *info)
 
 void SCR_TB_shift(struct SCR_Screen *screen, enum SCR_TB_Dir dir, u16 amount)
 {
-	u8 *buf = screen->TileBuffer;
+	SCR_TB_markDirty(screen, SCR_TB_ALL_ROWS);
+
 	switch (dir) {
 	case SCR_TB_Dir_LEFT:
-		for (u8 *i = buf; i < buf + SCR_TB_BUFFER_SIZE; i += SCR_TB_FULL_PLANE_WIDTH)
-			memmove(i, i + amount, SCR_TB_PLANE_WIDTH - amount);
+		screen->TileOriginX = (screen->TileOriginX + amount) % SCR_TB_RING_WIDTH;
 		break;
 	case SCR_TB_Dir_RIGHT:
-		for (u8 *i = buf; i < buf + SCR_TB_BUFFER_SIZE; i += SCR_TB_FULL_PLANE_WIDTH)
-			memmove(i + amount, i, SCR_TB_PLANE_WIDTH - amount);
+		screen->TileOriginX =
+				(screen->TileOriginX + SCR_TB_RING_WIDTH - amount) % SCR_TB_RING_WIDTH;
 		break;
 	case SCR_TB_Dir_UP:
-		{
-			u16 offset = SCR_TB_SPRITES_WIDTH * amount;
-			memmove(buf, buf + offset, SCR_TB_BUFFER_SIZE - offset);
-		}
+		screen->TileOriginY = (screen->TileOriginY + amount) % SCR_TB_SPRITES_HEIGHT;
 		break;
 	case SCR_TB_Dir_DOWN:
-		{
-			u16 offset = SCR_TB_SPRITES_WIDTH * amount;
-			memmove(buf + offset, buf, SCR_TB_BUFFER_SIZE - offset);
-		}
+		screen->TileOriginY =
+				(screen->TileOriginY + SCR_TB_SPRITES_HEIGHT - amount) % SCR_TB_SPRITES_HEIGHT;
 		break;
 	}
 }
 
+u16 SCR_TB_getOffset(const struct SCR_Screen *screen, u16 x, u16 y)
+{
+	x += screen->TileOriginX;
+	if (x >= SCR_TB_RING_WIDTH)
+		x -= SCR_TB_RING_WIDTH;
+
+	y += screen->TileOriginY;
+	if (y >= SCR_TB_SPRITES_HEIGHT)
+		y -= SCR_TB_SPRITES_HEIGHT;
+
+	return x + y * SCR_TB_SPRITES_WIDTH;
+}
+
+// Returns the sprite to draw for the frame of the animation `sprite` is on.
+static u16 animFrame(const struct SCR_Screen *screen, u16 sprite)
+{
+	if (screen->TileBank.Anims == NULL)
+		return sprite;
+
+	const struct SCR_SpriteAnim *anim = &screen->TileBank.Anims[sprite];
+	if (anim->Frames == 1)
+		return sprite;
+
+	return sprite + screen->AnimTick / anim->Rate % anim->Frames;
+}
+
+// Returns whether either sprite of the tile changes frames on this animation tick. Only for
+// tiles that animate.
+static bool animChanges(const struct SCR_Screen *screen, const struct MAP_TileDef *tile)
+{
+	const struct SCR_SpriteAnim *back = &screen->TileBank.Anims[tile->Back];
+	const struct SCR_SpriteAnim *front = &screen->TileBank.Anims[tile->Front];
+
+	return (back->Frames != 1 && screen->AnimTick % back->Rate == 0) ||
+			(front->Frames != 1 && screen->AnimTick % front->Rate == 0);
+}
+
+// Masks the front sprite of the tile over the back sprite into `out`, using the current frame
+// of each if they animate, and finds the foreground mask of the tile.
+static void compositeTile(const struct SCR_Screen *screen, const struct MAP_TileDef *tile,
+		SCR_CompositeSprite out)
+{
+	const SCR_SpriteBuffer *bank = screen->TileBank.Sprites;
+
+	const SCR_SpriteBuffer *back = &bank[animFrame(screen, tile->Back)];
+	const SCR_SpriteBuffer *front = &bank[animFrame(screen, tile->Front)];
+
+	for (u16 row = 0; row < SCR_SPRITE_SIZE; row++) {
+		out[SCR_SPRITE_DARK][row] = ((*back)[SCR_SPRITE_DARK][row] &
+				(*front)[SCR_SPRITE_MASK][row]) | (*front)[SCR_SPRITE_DARK][row];
+		out[SCR_SPRITE_LIGHT][row] = ((*back)[SCR_SPRITE_LIGHT][row] &
+				(*front)[SCR_SPRITE_MASK][row]) | (*front)[SCR_SPRITE_LIGHT][row];
+
+		if (tile->IsBackFg)
+			out[SCR_COMPOSITE_FG][row] = 0xFF;
+		else if (tile->IsFrontFg)
+			out[SCR_COMPOSITE_FG][row] = ~(*front)[SCR_SPRITE_MASK][row];
+		else
+			out[SCR_COMPOSITE_FG][row] = 0x00;
+	}
+}
+
+// Returns whether the level definition at `index` animates.
+#define isAnimatedDef(screen, index) (((screen)->AnimatedDefs[(index) / 8] >> ((index) % 8)) & 1)
+
+void SCR_TB_initLevel(struct SCR_Screen *screen, const struct MAP_Map *map)
+{
+	SCR_TB_deInitLevel(screen);
+
+	screen->LevelDefs = map->Defs;
+	screen->NumLevelDefs = map->NumDefs;
+
+	const struct SCR_SpriteAnim *anims = screen->TileBank.Anims;
+
+	for (u16 i = 0; i < map->NumDefs && anims != NULL; i++) {
+		const struct MAP_TileDef *def = &map->Defs[i];
+		if (anims[def->Back].Frames != 1 || anims[def->Front].Frames != 1)
+			screen->AnimatedDefs[i / 8] |= 1 << (i % 8);
+	}
+
+	// Animated definitions are composited every time they change frames, so they would never
+	// be read from the cache and don't get a slot in it.
+	u16 num_defs = 0;
+	for (u16 i = 0; i < map->NumDefs && num_defs < SCR_TB_MAX_CACHED_DEFS; i++) {
+		if (!isAnimatedDef(screen, i))
+			num_defs++;
+	}
+
+	if (num_defs == 0)
+		return;
+
+	// Running out of memory is fine since the tiles can still be composited when drawn.
+	screen->TileCache = HeapAllocPtr(sizeof(SCR_CompositeSprite) * num_defs);
+	if (screen->TileCache == NULL)
+		return;
+
+	for (u16 i = 0, slot = 0; slot < num_defs; i++) {
+		if (isAnimatedDef(screen, i))
+			continue;
+
+		compositeTile(screen, &map->Defs[i], screen->TileCache[slot]);
+		screen->CacheSlots[i] = ++slot;
+	}
+
+	screen->NumCachedDefs = num_defs;
+}
+
+void SCR_TB_deInitLevel(struct SCR_Screen *screen)
+{
+	if (screen->TileCache != NULL)
+		HeapFreePtr(screen->TileCache);
+
+	screen->LevelDefs = NULL;
+	screen->NumLevelDefs = 0;
+	screen->TileCache = NULL;
+	screen->NumCachedDefs = 0;
+	memset(screen->AnimatedDefs, 0, sizeof(screen->AnimatedDefs));
+	memset(screen->CacheSlots, 0, sizeof(screen->CacheSlots));
+
+	if (screen->AnimSlots != NULL)
+		memset(screen->AnimSlots, 0, sizeof(*screen->AnimSlots) * SCR_TB_NUM_CELLS);
+	screen->NumAnimTiles = 0;
+	screen->AnimTick = 0;
+}
+
+// Records that the ring cell at `offset` now holds `tile`, adding it to or removing it from the
+// animated tiles depending on whether `tile` animates.
+static void setAnimSlot(struct SCR_Screen *screen, const struct MAP_TileDef *tile, bool animated,
+		u16 offset)
+{
+	u16 *slot = &screen->AnimSlots[offset % SCR_TB_SPRITES_WIDTH +
+			offset / SCR_TB_SPRITES_WIDTH * SCR_TB_RING_WIDTH];
+
+	if (animated) {
+		if (*slot == 0) {
+			*slot = ++screen->NumAnimTiles;
+			screen->AnimTiles[*slot - 1].Offset = offset;
+		}
+		screen->AnimTiles[*slot - 1].Def = tile;
+	} else if (*slot != 0) {
+		// Move the last animated tile into the removed one's place.
+		struct SCR_TB_AnimTile *last = &screen->AnimTiles[--screen->NumAnimTiles];
+
+		screen->AnimTiles[*slot - 1] = *last;
+		screen->AnimSlots[last->Offset % SCR_TB_SPRITES_WIDTH +
+				last->Offset / SCR_TB_SPRITES_WIDTH * SCR_TB_RING_WIDTH] = *slot;
+		*slot = 0;
+	}
+}
+
 void SCR_TB_drawTile(struct SCR_Screen *screen, const struct MAP_TileDef *tile, u16 offset)
 {
 	u8 *dark = screen->TileBuffer + offset;
 	u8 *light = dark + SCR_TB_PLANE_SIZE;
+	u8 *fg = dark + SCR_TB_FG_OFFSET;
 
-	const SCR_SpriteBuffer *bank = screen->TileBank;
+	SCR_TB_markDirty(screen, 1 << (offset / SCR_TB_SPRITES_WIDTH));
+
+	bool in_level = tile >= screen->LevelDefs && tile < screen->LevelDefs + screen->NumLevelDefs;
+	u16 index = in_level ? tile - screen->LevelDefs : 0;
+	bool animated = in_level && isAnimatedDef(screen, index);
+
+	setAnimSlot(screen, tile, animated, offset);
+
+	// Animated definitions, definitions outside the map, like the solid tiles past the edges,
+	// and definitions past the cache limit aren't in the cache, so they have to be composited
+	// now.
+	const u8 (*sprite)[SCR_SPRITE_SIZE];
+	SCR_CompositeSprite composite;
+
+	u16 slot = in_level ? screen->CacheSlots[index] : 0;
+	if (slot != 0) {
+		sprite = screen->TileCache[slot - 1];
+	} else {
+		compositeTile(screen, tile, composite);
+		sprite = (const u8 (*)[SCR_SPRITE_SIZE])composite;
+	}
 
 	// Air is intentionally drawn because tiles shifted out in SCR_TB_shift are not erased, so
-	// air will erase them.
+	// air will erase them. Each tile is in both copies of the ring.
 	for (u16 row = 0, offset = 0; row < SCR_SPRITE_SIZE;
 			row++, offset += SCR_TB_FULL_PLANE_WIDTH) {
-		*(dark + offset) = bank[tile->Back][SCR_SPRITE_DARK][row];
-		*(light + offset) = bank[tile->Back][SCR_SPRITE_LIGHT][row];
-
-		*(dark + offset) &= bank[tile->Front][SCR_SPRITE_MASK][row];
-		*(dark + offset) |= bank[tile->Front][SCR_SPRITE_DARK][row];
-		*(light + offset) &= bank[tile->Front][SCR_SPRITE_MASK][row];
-		*(light + offset) |= bank[tile->Front][SCR_SPRITE_LIGHT][row];
+		*(dark + offset) = *(dark + offset + SCR_TB_RING_WIDTH) = sprite[SCR_SPRITE_DARK][row];
+		*(light + offset) = *(light + offset + SCR_TB_RING_WIDTH) =
+				sprite[SCR_SPRITE_LIGHT][row];
+		*(fg + offset) = *(fg + offset + SCR_TB_RING_WIDTH) = sprite[SCR_COMPOSITE_FG][row];
 	}
 }
 
 void SCR_TB_drawTileColumn(struct SCR_Screen *screen, struct MAP_Map *map, MAP_Pos tile_x,
 		MAP_Pos tile_y, u16 x)
 {
-	s16 end = tile_y + SCR_TB_SPRITES_HEIGHT;
-	for (; tile_y < end; tile_y++, x += SCR_TB_SPRITES_WIDTH)
-		SCR_TB_drawTile(screen, MAP_getTile(map, tile_x, tile_y), x);
+	u16 offset = SCR_TB_getOffset(screen, x, 0);
+
+	struct MAP_Span span;
+	MAP_initSpan(&span, map, tile_x, tile_y, SCR_TB_SPRITES_HEIGHT, MAP_SpanDir_DOWN);
+
+	for (u16 length; (length = MAP_nextSegment(&span)) != 0;) {
+		for (; length > 0; length--, span.Indices += span.Stride) {
+			SCR_TB_drawTile(screen, &span.Defs[*span.Indices], offset);
+
+			offset += SCR_TB_SPRITES_WIDTH;
+			if (offset >= SCR_TB_PLANE_SIZE)
+				offset -= SCR_TB_PLANE_SIZE;
+		}
+	}
 }
 
 void SCR_TB_drawTileRow(struct SCR_Screen *screen, struct MAP_Map *map, MAP_Pos tile_x,
 		MAP_Pos tile_y, u16 y)
 {
-	s16 end = tile_x + SCR_TB_PLANE_WIDTH;
-	for (; tile_x < end; tile_x++, y++)
-		SCR_TB_drawTile(screen, MAP_getTile(map, tile_x, tile_y), y);
+	u16 offset = SCR_TB_getOffset(screen, 0, y);
+	u16 ring_end = offset - screen->TileOriginX + SCR_TB_RING_WIDTH;
+
+	struct MAP_Span span;
+	MAP_initSpan(&span, map, tile_x, tile_y, SCR_TB_PLANE_WIDTH, MAP_SpanDir_RIGHT);
+
+	for (u16 length; (length = MAP_nextSegment(&span)) != 0;) {
+		for (; length > 0; length--, span.Indices += span.Stride) {
+			SCR_TB_drawTile(screen, &span.Defs[*span.Indices], offset);
+
+			if (++offset == ring_end)
+				offset -= SCR_TB_RING_WIDTH;
+		}
+	}
 }
 
 void SCR_TB_drawAllTiles(struct SCR_Screen *screen, struct MAP_Map *map, MAP_Pos tile_x,
 		MAP_Pos tile_y)
 {
-	for (u16 y = 0; tile_y < SCR_TB_SPRITES_HEIGHT; tile_y += 1, y += SCR_TB_SPRITES_WIDTH)
+	for (u16 y = 0; y < SCR_TB_SPRITES_HEIGHT; tile_y += 1, y += 1)
 		SCR_TB_drawTileRow(screen, map, tile_x, tile_y, y);
 }
 
-// TODO: Implement this
-void SCR_TB_updateAnimatedTiles(struct SCR_Screen *screen, struct MAP_Map *map,
-		MAP_Pos tile_x, MAP_Pos tile_y)
+void SCR_TB_updateAnimatedTiles(struct SCR_Screen *screen)
 {
-	(void)screen;
-	(void)map;
-	(void)tile_x;
-	(void)tile_y;
+	screen->AnimTick++;
+
+	// Redrawing a tile that is already animated never changes `AnimTiles`.
+	for (u16 i = 0; i < screen->NumAnimTiles; i++) {
+		const struct SCR_TB_AnimTile *anim_tile = &screen->AnimTiles[i];
+		if (animChanges(screen, anim_tile->Def))
+			SCR_TB_drawTile(screen, anim_tile->Def, anim_tile->Offset);
+	}
 }
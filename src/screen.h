@@ -81,10 +81,115 @@
 // A buffer large enough to hold a single sprite.
 typedef u8 SCR_SpriteBuffer[3][SCR_SPRITE_SIZE];
 
+// A tile's back and front sprites masked together into just a dark and light sprite, plus the
+// foreground mask of the pixels that are drawn over objects.
+typedef u8 SCR_CompositeSprite[3][SCR_SPRITE_SIZE];
+
+// In a composite sprite, the foreground mask takes the place of the mask. Set bits are
+// foreground, unlike the mask.
+#define SCR_COMPOSITE_FG 2
+
+// Animation information for a sprite in a sprite bank. The rest of the frames of an animated
+// sprite directly follow it in the bank.
+struct SCR_SpriteAnim
+{
+	u8 Frames; // Number of frames, which is one for sprites that don't animate
+	u8 Rate;   // Number of animation ticks each frame lasts
+};
+
+// Flags in a sprite bank's mask information describing a sprite's mask.
+enum SCR_MaskInfo
+{
+	SCR_MaskInfo_OPAQUE = 1 << 0, // The mask is all zeros, so it hides everything behind it.
+	SCR_MaskInfo_CLEAR  = 1 << 1  // The mask is all ones and the sprite has no pixels.
+};
+
+// Sprite bank files:
+/*
+	Sprites are stored in `sgls` files, which are read in place with `HeapDeref`, whether they
+	are archived or not. This means that a sprite bank takes no heap memory and no time to load
+	no matter how large it is. All numbers are big endian, and the file consists of:
+	* A `SCR_BankHeader`.
+	* If `SCR_BankFlag_ANIMS` is set, a `SCR_SpriteAnim` for each sprite.
+	* If `SCR_BankFlag_MASK_INFO` is set, a byte of `SCR_MaskInfo` flags for each sprite.
+	* A `SCR_SpriteBuffer` for each sprite.
+	Banks without animation information don't animate, and banks without mask information have
+	no known opaque or clear sprites.
+*/
+
+// The version of sprite bank files that this version of SGL reads
+#define SCR_BANK_VERSION 1
+
+// Flags in a sprite bank header saying which optional sections the file has.
+enum SCR_BankFlag
+{
+	SCR_BankFlag_ANIMS     = 1 << 0,
+	SCR_BankFlag_MASK_INFO = 1 << 1
+};
+
+// The header at the start of a sprite bank file.
+struct SCR_BankHeader
+{
+	char Magic[4];  // Always "SGLS"
+	u16 Version;    // SCR_BANK_VERSION
+	u16 NumSprites;
+	u16 Flags;      // enum SCR_BankFlag
+};
+
+// A bank of sprites pointing straight into the memory of its file.
+struct SCR_SpriteBank
+{
+	// The open file, or H_NULL for banks built into the program
+	FILES File;
+
+	u16 NumSprites;
+	const SCR_SpriteBuffer *Sprites;
+	// Animation information for each sprite, or NULL if nothing animates
+	const struct SCR_SpriteAnim *Anims;
+	// `SCR_MaskInfo` flags for each sprite, or NULL if there are none
+	const u8 *MaskInfo;
+};
+
+// An animated tile in the tile buffer; see `SCR_TB_updateAnimatedTiles`.
+struct SCR_TB_AnimTile
+{
+	const struct MAP_TileDef *Def;
+	u16 Offset;
+};
+
 // Defines the dimensions of something in pixels
 typedef s16 SCR_Pixel;
 #define SCR_Pixel_POINT 3
 
+// The size of the memory accesses that `SCR_drawTileBuffer` copies with.
+enum SCR_BlitWidth
+{
+	SCR_BlitWidth_WORD, // u16 at a time
+	SCR_BlitWidth_LONG, // u32 at a time; screen rows are only u16 aligned, but the 68k allows it
+	SCR_BlitWidth_LEN
+};
+
+// The blit width `SCR_init` chooses. `host/bench.c` compares the widths on each calculator.
+#define SCR_DEFAULT_BLIT_WIDTH SCR_BlitWidth_LONG
+
+// The screen bytes under one sprite of an object, saved by `SCR_drawObject` so that
+// `SCR_drawTileBuffer` can put them back instead of drawing the tile buffer over them.
+struct SCR_SavedRect
+{
+	// Byte offset of the top left byte from the top left of the game area
+	u16 Offset;
+	// Number of rows and number of bytes in each row, which is one or two
+	u8 Height;
+	u8 Width;
+
+	u8 Dark[SCR_SPRITE_SIZE][2];
+	u8 Light[SCR_SPRITE_SIZE][2];
+};
+
+// The most sprites that can be saved under for each gray buffer. Sprites past this are erased
+// by drawing their rows of the tile buffer instead.
+#define SCR_MAX_SAVED_RECTS 48
+
 // A struct containing all data relevant to the screen.
 struct SCR_Screen
 {
@@ -93,18 +198,49 @@ struct SCR_Screen
 
 	// Tile buffer; see the SCR_TB namespace documentation for more info
 	u8 *TileBuffer;
+	// Ring column and row of the top left visible tile in the tile buffer
+	u16 TileOriginX;
+	u16 TileOriginY;
+	// Which copy loop `SCR_drawTileBuffer` uses
+	enum SCR_BlitWidth BlitWidth;
+	// Tile definitions of the current level, set by `SCR_TB_initLevel`
+	const struct MAP_TileDef *LevelDefs;
+	u16 NumLevelDefs;
+	// Composited sprites of the first `NumCachedDefs` level definitions that don't animate
+	SCR_CompositeSprite *TileCache;
+	u16 NumCachedDefs;
+	// For each level definition, its index in `TileCache` plus one, or zero if it isn't cached
+	u8 CacheSlots[256];
+	// Bitmask of which level definitions animate, indexed by `MAP_TileIndex`
+	u8 AnimatedDefs[256 / 8];
+
+	// Animated tiles in the tile buffer, and for each ring cell, the index of its tile in
+	// `AnimTiles` plus one, or zero if the tile there doesn't animate
+	struct SCR_TB_AnimTile *AnimTiles;
+	u16 NumAnimTiles;
+	u16 *AnimSlots;
+	// Number of times `SCR_TB_updateAnimatedTiles` has been called this level
+	u16 AnimTick;
+
+	// For each gray buffer, a bitmask of the ring rows of the tile buffer that changed since the
+	// tile buffer was last drawn to it; see `SCR_TB_markDirty`.
+	u16 DirtyRows[2];
+
+	// For each gray buffer, the sprites drawn to it since it was last erased, in the order they
+	// were drawn. Each buffer has `SCR_MAX_SAVED_RECTS` of them, starting at `SCR_MAX_SAVED_RECTS`
+	// times the index of the buffer.
+	struct SCR_SavedRect *SavedRects;
+	u16 NumSavedRects[2];
 
-	// Pointers to the start of banks of sprites
 	// Static tile sprite bank
-	FILES TileBankFile;
-	const SCR_SpriteBuffer *TileBank;
-
+	struct SCR_SpriteBank TileBank;
 	// Object sprite bank
-	FILES ObjBankFile;
-	const SCR_SpriteBuffer *ObjBank;
+	struct SCR_SpriteBank ObjBank;
 };
 
-// Initializes the screen by starting grayscale, allocating screen buffers, and loading sprites.
+// Initializes the screen by starting grayscale, allocating screen buffers, and loading sprites
+// from "sgl\tiles" and "sgl\objects". For now, the temporary sprites built into the program
+// are used for either bank if there is no file for it.
 void SCR_init(struct SCR_Screen *screen);
 // Deinitializes the screen.
 void SCR_deInit(struct SCR_Screen *screen);
@@ -140,16 +276,34 @@ void SCR_drawTile(const struct SCR_Screen *screen, SCR_Pixel x, SCR_Pixel y,
 
 struct OBJ_Object;
 
-// Draw an object to the screen.
-void SCR_drawObject(const struct OBJ_Object *obj);
+// Draw an object to the game area of the screen over whatever is already there, clipping it to
+// the edges. Objects wider or taller than a sprite use consecutive sprites in the object bank,
+// stored in rows from the top left, and each `SpriteOffset` frame follows the previous one.
+// `FlipAcrossX` mirrors the object horizontally and `FlipAcrossY` vertically. Foreground tiles
+// in the tile buffer hide the object. What the object covers is saved so that
+// `SCR_drawTileBuffer` can put it back to erase the object; if too many sprites have been drawn
+// to save it, the rows of the tile buffer under it are marked dirty instead. In levels that
+// wrap, the object is also drawn on the other side of the edges of the level.
+void SCR_drawObject(struct SCR_Screen *screen, const struct MAP_Map *map,
+		const struct OBJ_Object *obj);
+
+// Draws `text` in black over the whole HUD with the four pixel font, which only has digits, so
+// anything else is a space. Only as many characters as fit are drawn.
+void SCR_drawHudText(const char *text);
 
 // Draws the tile buffer to the screen, shifting it a specified number of pixels to the top left
 // corner of the screen, where the shift must be in the range [0, 7]. Drawing the tile buffer
 // replaces the screen contents except for the HUD area, so clearing the screen is unnecessary.
-void SCR_drawTileBuffer(const struct SCR_Screen *screen, SCR_Pixel shift_left, SCR_Pixel shift_up);
+// Only rows marked dirty for the hidden buffer are drawn, so the shift must only change through
+// `SCR_scroll` or `SCR_scrollAbsolute`, which mark everything dirty. When not everything is
+// dirty, objects drawn to the hidden buffer last time are erased by restoring what they covered
+// first, so a camera that doesn't scroll costs little more than the objects that move.
+void SCR_drawTileBuffer(struct SCR_Screen *screen, SCR_Pixel shift_left, SCR_Pixel shift_up);
 
 // Scroll the map a certain amount, also shifting and updating the tile buffer appropriately
-// as well. The shift must not be greater than eight pixels.
+// as well. The shift can be any distance: the tile buffer is shifted by as many tiles as were
+// crossed and only the columns and rows shifted in are drawn, unless drawing the whole tile
+// buffer would be cheaper. Streamed maps page in the columns around the new position first.
 void SCR_scroll(struct SCR_Screen *screen, struct MAP_Map *map, MAP_Scroll shift_x,
 		MAP_Scroll shift_y);
 
@@ -185,24 +339,44 @@ void SCR_dispError(const char *text1, const char *text2);
 	a tile boundary or when tiles animate. Still, the cost is negligible compared to redrawing
 	multiple layers every frame.
 
-	The tile buffer is a single chunk of memory holding a back and front buffer. Each buffer
-	has enough space to hold SCR_SCROLL_SPRITES in the X and Y directions. Each sprite is
-	aligned to a byte boundary and is only shifted pixel amounts when drawing the tile buffer
-	to the screen. There is a catch: after each row of pixels, there is one blank padding byte
-	to align each row to a u16 boundary, which makes `SCR_drawTileBuffer` much faster than
-	single byte copying.
+	The tile buffer is a single chunk of memory holding a dark and light plane. Each plane has
+	enough space to hold SCR_SCROLL_SPRITES in the Y direction and one more than that in the X
+	direction. Each sprite is aligned to a byte boundary and is only shifted pixel amounts when
+	drawing the tile buffer to the screen.
+
+	After those comes the foreground plane, which is never drawn to the screen. It has a set
+	bit for every pixel of a tile that objects pass behind: all of a tile whose back sprite is
+	in the foreground, or the opaque pixels of the front sprite if only it is. Instead of
+	drawing the foreground tiles again over the objects, `SCR_drawObject` masks the foreground
+	out of each row of the object as it draws it.
+
+	All planes are rings in both directions. Instead of moving the whole buffer whenever the
+	screen scrolls over a tile boundary, `SCR_TB_shift` only moves the origin, which is the
+	ring column and row of the top left visible tile (`TileOriginX` and `TileOriginY` in
+	`SCR_Screen`), and the tiles that scrolled out are drawn over by the newly exposed ones.
+	`SCR_TB_getOffset` finds where a visible tile is in the ring.
+
+	`SCR_drawTileBuffer` handles the seam at the bottom of the ring by wrapping back to the
+	top. Wrapping in the middle of every row would be far too slow, so instead each row of
+	pixels holds the ring twice, side by side, and every tile is drawn to both copies. This way,
+	a full row can be read starting from any column. The extra column exists so that rows can
+	always be copied as u16s: if the origin is on an odd byte, copying starts one byte earlier,
+	in the extra column, and that byte is shifted out.
 */
 
 // Note: WIDTH and SIZE are in bytes, while height is in other units, usually to be used as a
 // multiplier for width.
 
+// Width in sprites of the ring, including the extra alignment column
+#define SCR_TB_RING_WIDTH (SCR_SCROLL_SPRITES_X + 1)
+
 // Width in bytes of one row of sprites
-#define SCR_TB_SPRITES_WIDTH ((SCR_SCROLL_SPRITES_X + 1) * SCR_SPRITE_SIZE)
+#define SCR_TB_SPRITES_WIDTH (SCR_TB_FULL_PLANE_WIDTH * SCR_SPRITE_SIZE)
 // Height in sprites of one plane
 #define SCR_TB_SPRITES_HEIGHT SCR_SCROLL_SPRITES_Y
 
-// Width in bytes of one row of pixels, including invisible alignment byte
-#define SCR_TB_FULL_PLANE_WIDTH (SCR_SCROLL_SPRITES_X + 1)
+// Width in bytes of one row of pixels, which holds two copies of the ring
+#define SCR_TB_FULL_PLANE_WIDTH (SCR_TB_RING_WIDTH * 2)
 // Width in bytes of one row of visible pixels.
 #define SCR_TB_PLANE_WIDTH SCR_SCROLL_SPRITES_X
 // Height in pixels of one plane
@@ -211,7 +385,10 @@ void SCR_dispError(const char *text1, const char *text2);
 // Size in bytes of one plane
 #define SCR_TB_PLANE_SIZE (SCR_TB_FULL_PLANE_WIDTH * SCR_TB_PLANE_HEIGHT)
 // Size in bytes of the whole buffer
-#define SCR_TB_BUFFER_SIZE (SCR_TB_PLANE_SIZE * 2)
+#define SCR_TB_BUFFER_SIZE (SCR_TB_PLANE_SIZE * 3)
+
+// Byte offset of the foreground plane in the tile buffer
+#define SCR_TB_FG_OFFSET (SCR_TB_PLANE_SIZE * 2)
 
 // Defines the direction to shift in `SCR_TB_shift`.
 enum SCR_TB_Dir
@@ -222,22 +399,55 @@ enum SCR_TB_Dir
 	SCR_TB_Dir_DOWN,
 };
 
-// Shifts the tile buffer `amount` sprites in the direction `dir`. `amount` may not be greater
-// than or equal to SCR_TB_PLANE_WIDTH if shifting horizontally or greater than
-// SCR_TB_PLANE_HEIGHT if shifting vertically. It does not erase tiles in the space shifted out.
+// Shifts the tile buffer `amount` sprites in the direction `dir` by moving the origin, so the
+// tiles shifted out on one side come back in on the other. `amount` may not be greater than
+// SCR_TB_RING_WIDTH if shifting horizontally or SCR_TB_SPRITES_HEIGHT if shifting vertically.
+// It does not erase tiles in the space shifted in.
 void SCR_TB_shift(struct SCR_Screen *screen, enum SCR_TB_Dir dir, u16 amount);
 
-// Draws a tile to the tile buffer at the specified byte offset in the tile buffer. Overwrites
-// any tile previously at that position.
+// Bitmask of every row of the tile buffer for `SCR_TB_markDirty`.
+#define SCR_TB_ALL_ROWS ((1 << SCR_TB_SPRITES_HEIGHT) - 1)
+
+// Marks the ring rows in the bitmask `rows` to be drawn to both gray buffers the next time
+// `SCR_drawTileBuffer` draws to each of them. Drawing tiles and shifting or scrolling the tile
+// buffer does this automatically, but anything else that draws over the game area of the screen
+// must mark `SCR_TB_ALL_ROWS` so the tile buffer gets drawn back over it.
+#define SCR_TB_markDirty(screen, rows) \
+		((screen)->DirtyRows[0] |= (rows), (screen)->DirtyRows[1] |= (rows))
+
+// Returns the byte offset in the tile buffer of the visible tile at column `x` and row `y`,
+// where (0, 0) is the top left. `x` must be less than SCR_TB_RING_WIDTH and `y` less than
+// SCR_TB_SPRITES_HEIGHT.
+u16 SCR_TB_getOffset(const struct SCR_Screen *screen, u16 x, u16 y);
+
+// Number of tiles in the ring, including the extra column
+#define SCR_TB_NUM_CELLS (SCR_TB_RING_WIDTH * SCR_TB_SPRITES_HEIGHT)
+
+// The most tile definitions that `SCR_TB_initLevel` will composite. This keeps the cache to
+// 3 KB; levels that have more definitions that don't animate than this composite the rest as
+// they are drawn.
+#define SCR_TB_MAX_CACHED_DEFS 128
+
+// Prepares the tile buffer for the level using `map`. It finds which tile definitions animate,
+// and it composites the back and front sprites of the ones that don't ahead of time so that
+// drawing them to the tile buffer is a plain copy. If there is not enough memory for the
+// cache, tiles are composited as they are drawn like normal instead. Tile definitions that
+// are not in the level's definitions, like those off the edges of the map, never animate.
+void SCR_TB_initLevel(struct SCR_Screen *screen, const struct MAP_Map *map);
+// Frees what `SCR_TB_initLevel` allocated, if anything. `SCR_deInit` also does this.
+void SCR_TB_deInitLevel(struct SCR_Screen *screen);
+
+// Draws a tile to the tile buffer at the specified byte offset, as returned by
+// `SCR_TB_getOffset`. Overwrites any tile previously at that position.
 void SCR_TB_drawTile(struct SCR_Screen *screen, const struct MAP_TileDef *tile, u16 offset);
 
-// Draws a column of tiles from the map as tall as the tile buffer at the byte offset `x`.
+// Draws a column of tiles from the map as tall as the tile buffer at the visible column `x`.
 // The top tile to draw is at position (`tile_x`, `tile_y`). Overwrites tiles previously
 // at the positions being drawn to.
 void SCR_TB_drawTileColumn(struct SCR_Screen *screen, struct MAP_Map *map, MAP_Pos tile_x,
 		MAP_Pos tile_y, u16 x);
 
-// Draws a row of tiles from the map as wide as the tile buffer at the byte offset `y`.
+// Draws a row of tiles from the map as wide as the tile buffer at the visible row `y`.
 // The top tile to draw is at position (`tile_x`, `tile_y`). Overwrites tiles previously
 // at the positions being drawn to.
 void SCR_TB_drawTileRow(struct SCR_Screen *screen, struct MAP_Map *map, MAP_Pos tile_x,
@@ -248,6 +458,7 @@ void SCR_TB_drawTileRow(struct SCR_Screen *screen, struct MAP_Map *map, MAP_Pos
 void SCR_TB_drawAllTiles(struct SCR_Screen *screen, struct MAP_Map *map, MAP_Pos tile_x,
 		MAP_Pos tile_y);
 
-// Redraws all animated tiles in the tile buffer.
-void SCR_TB_updateAnimatedTiles(struct SCR_Screen *screen, struct MAP_Map *map,
-		MAP_Pos tile_x, MAP_Pos tile_y);
+// Advances tile animations by one tick and redraws the animated tiles in the tile buffer whose
+// frame changed. `SCR_TB_drawTile` keeps track of where they are, so this doesn't have to
+// search for them.
+void SCR_TB_updateAnimatedTiles(struct SCR_Screen *screen);
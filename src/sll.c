@@ -0,0 +1,60 @@
+// Super Grayland: Copyright 2021 Vincent Robinson under the zlib license.
+// See `license.txt` for more information.
+// Before delving into the code, please read `readme_source.txt` to understand the basic design.
+
+#include "sll.h"
+
+void SLL_linkAfter(struct SLL_Base *base, u16 index, u16 left)
+{
+	struct SLL_Links *links = base->Links;
+	u16 right = left == SLL_NULL ? base->First : links[left].Right;
+
+	links[index].Left = left;
+	links[index].Right = right;
+
+	if (left == SLL_NULL)
+		base->First = index;
+	else
+		links[left].Right = index;
+
+	if (right == SLL_NULL)
+		base->Last = index;
+	else
+		links[right].Left = index;
+}
+
+void SLL_unlink(struct SLL_Base *base, u16 index)
+{
+	struct SLL_Links *links = base->Links;
+	u16 left = links[index].Left;
+	u16 right = links[index].Right;
+
+	if (left == SLL_NULL)
+		base->First = right;
+	else
+		links[left].Right = right;
+
+	if (right == SLL_NULL)
+		base->Last = left;
+	else
+		links[right].Left = left;
+}
+
+void SLL_relink(struct SLL_Base *base, u16 from, u16 to)
+{
+	struct SLL_Links *links = base->Links;
+	u16 left = links[from].Left;
+	u16 right = links[from].Right;
+
+	links[to] = links[from];
+
+	if (left == SLL_NULL)
+		base->First = to;
+	else
+		links[left].Right = to;
+
+	if (right == SLL_NULL)
+		base->Last = to;
+	else
+		links[right].Left = to;
+}
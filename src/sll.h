@@ -0,0 +1,189 @@
+// Super Grayland: Copyright 2021 Vincent Robinson under the zlib license.
+// See `license.txt` for more information.
+// Before delving into the code, please read `readme_source.txt` to understand the basic design.
+
+#pragma once
+
+#include "common.h"
+
+// SLL Namespace: Sorted linked lists
+/*
+	A sorted linked list keeps structs sorted by a key, such as objects by the column of tiles
+	they're in, so that everything near a position can be found by walking left and right from
+	anything else near it. Both the objects of a level and the map objects in the editor are kept in them.
+
+	The structs aren't allocated separately like in most linked lists. All of them are in one
+	array in no particular order, and the links are u16 indices into it, kept in a parallel
+	array of `SLL_Links` so that walking the list doesn't drag whole structs through memory.
+	Adding puts the new struct at the end of the array and links it in. Removing moves the last
+	struct into the hole and fixes up the links to it, so the array never has gaps and nothing
+	is allocated after the list is made.
+
+	Finding where something goes is a walk from a hint, which should be the index of something
+	with a nearby key, like the object that spawned it. Likewise, things whose keys change by a
+	little at a time, like the positions of objects, are moved back into order by stepping past
+	their neighbours. So, the cost of both depends on how far things move rather than on how
+	many there are.
+
+	Lists are specialized for each struct so that keys are compared inline. `SLL_DECLARE(type)`
+	declares the list of `struct type` and its functions, which are called
+	`SLL_<type>_<function>`, and `SLL_DEFINE(type, key)` defines them in one `.c` file, where
+	`key` is a function-like macro giving the key of a `const struct type *`. The linking itself
+	doesn't depend on the type, so it is shared by every list through the `SLL_Base` functions.
+*/
+
+// Index of no node, like a NULL pointer
+#define SLL_NULL 0xFFFF
+
+// The neighbours of a node, which are SLL_NULL at the ends of the list.
+struct SLL_Links
+{
+	u16 Left;
+	u16 Right;
+};
+
+// The part of a list that doesn't depend on the type of its structs.
+struct SLL_Base
+{
+	// Links for each struct in the list
+	struct SLL_Links *Links;
+
+	// Number of structs in the list and how many there is room for
+	u16 Len;
+	u16 Cap;
+
+	// The leftmost and rightmost nodes, or SLL_NULL if the list is empty
+	u16 First;
+	u16 Last;
+};
+
+// Links the unlinked node `index` in right of `left`, or at the start if `left` is SLL_NULL.
+void SLL_linkAfter(struct SLL_Base *base, u16 index, u16 left);
+// Unlinks the node `index`, leaving its own links as they were.
+void SLL_unlink(struct SLL_Base *base, u16 index);
+// Moves the links of the node `from` to the unlinked node `to`, pointing its neighbours at it.
+void SLL_relink(struct SLL_Base *base, u16 from, u16 to);
+
+// The type of the list of `struct type`
+#define SLL_List(type) struct SLL_##type##_List
+
+// Declares the list of `struct type` and its functions.
+#define SLL_DECLARE(type)																	\
+	SLL_List(type)																			\
+	{																						\
+		struct SLL_Base Base;																\
+		/* The structs in the list, in no particular order */								\
+		struct type *Items;																	\
+	};																						\
+																							\
+	/* Allocates room for `cap` structs. Throws an error if there isn't enough memory. */		\
+	void SLL_##type##_init(SLL_List(type) *list, u16 cap);									\
+	/* Frees the list. It is safe to call this on lists that weren't initialized. */			\
+	void SLL_##type##_deInit(SLL_List(type) *list);											\
+																							\
+	/* Copies `item` into the list, finding its place by walking from the node `hint`,		\
+	   which can be SLL_NULL to walk from the start. It goes right of anything with the		\
+	   same key. Returns its index, or SLL_NULL if the list is full. */						\
+	u16 SLL_##type##_add(SLL_List(type) *list, const struct type *item, u16 hint);			\
+	/* Removes the node `index`. The last node in the array, which was at index `Len` after	\
+	   removing, is moved to `index`, so any indices to it must be changed. */				\
+	void SLL_##type##_remove(SLL_List(type) *list, u16 index);								\
+	/* Moves the node `index` back into order after its key changed. Returns TRUE if it		\
+	   moved. */																			\
+	bool SLL_##type##_sort(SLL_List(type) *list, u16 index)
+
+// Defines the functions of the list of `struct type` sorted by `key(const struct type *)`.
+#define SLL_DEFINE(type, key)																\
+	void SLL_##type##_init(SLL_List(type) *list, u16 cap)									\
+	{																						\
+		/* The structs come first since they need the most alignment. */					\
+		list->Items = HeapAllocPtr((sizeof(struct type) + sizeof(struct SLL_Links)) *		\
+				(u32)cap);																	\
+		if (list->Items == NULL)															\
+			COM_throwErr(COM_Error_MEMORY, "sorted list");									\
+																							\
+		list->Base.Links = (struct SLL_Links *)(list->Items + cap);							\
+		list->Base.Len = 0;																	\
+		list->Base.Cap = cap;																\
+		list->Base.First = list->Base.Last = SLL_NULL;										\
+	}																						\
+																							\
+	void SLL_##type##_deInit(SLL_List(type) *list)											\
+	{																						\
+		if (list->Items != NULL)															\
+			HeapFreePtr(list->Items);														\
+																							\
+		COM_zero(list);																		\
+	}																						\
+																							\
+	/* Returns the node that `index` belongs right of when its key is `node_key`, walking	\
+	   from `from`, which must not be `index`. */											\
+	static u16 findLeft_##type(const SLL_List(type) *list, u16 from,							\
+			typeof(key((const struct type *)NULL)) node_key)								\
+	{																						\
+		const struct SLL_Links *links = list->Base.Links;									\
+																							\
+		if (from == SLL_NULL) {																\
+			from = list->Base.First;														\
+			if (from == SLL_NULL)															\
+				return SLL_NULL;															\
+		}																					\
+																							\
+		if (key(&list->Items[from]) > node_key) {											\
+			/* Walk left until something isn't greater. */									\
+			do {																			\
+				from = links[from].Left;													\
+			} while (from != SLL_NULL && key(&list->Items[from]) > node_key);				\
+		} else {																			\
+			/* Walk right while the next thing isn't greater. */							\
+			u16 right;																		\
+			while ((right = links[from].Right) != SLL_NULL &&								\
+					key(&list->Items[right]) <= node_key)									\
+				from = right;																\
+		}																					\
+																							\
+		return from;																		\
+	}																						\
+																							\
+	u16 SLL_##type##_add(SLL_List(type) *list, const struct type *item, u16 hint)			\
+	{																						\
+		if (list->Base.Len == list->Base.Cap)												\
+			return SLL_NULL;																\
+																							\
+		u16 index = list->Base.Len++;														\
+		list->Items[index] = *item;															\
+																							\
+		SLL_linkAfter(&list->Base, index, findLeft_##type(list, hint, key(item)));			\
+		return index;																		\
+	}																						\
+																							\
+	void SLL_##type##_remove(SLL_List(type) *list, u16 index)								\
+	{																						\
+		SLL_unlink(&list->Base, index);														\
+																							\
+		u16 last = --list->Base.Len;														\
+		if (index != last) {																\
+			list->Items[index] = list->Items[last];											\
+			SLL_relink(&list->Base, last, index);											\
+		}																					\
+	}																						\
+																							\
+	bool SLL_##type##_sort(SLL_List(type) *list, u16 index)									\
+	{																						\
+		const struct SLL_Links *links = &list->Base.Links[index];							\
+		typeof(key((const struct type *)NULL)) node_key = key(&list->Items[index]);			\
+																							\
+		/* Nothing moves unless a neighbour is now on the wrong side, which is most of		\
+		   the time. */																		\
+		u16 from;																			\
+		if (links->Left != SLL_NULL && key(&list->Items[links->Left]) > node_key)			\
+			from = links->Left;																\
+		else if (links->Right != SLL_NULL && key(&list->Items[links->Right]) < node_key)		\
+			from = links->Right;															\
+		else																				\
+			return FALSE;																	\
+																							\
+		SLL_unlink(&list->Base, index);														\
+		SLL_linkAfter(&list->Base, index, findLeft_##type(list, from, node_key));			\
+		return TRUE;																		\
+	}